@@ -0,0 +1,235 @@
+/*
+*/
+	#include <stdbool.h>
+	#include <string.h>
+	#include "strbuf_arena.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Every allocation is aligned to this, and preceded by a header of this size which holds the allocation size
+	#define ALIGNMENT		((size_t)__BIGGEST_ALIGNMENT__)
+	#define ALIGN_UP(n)		(((n) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+	#define HEADER_SIZE		ALIGN_UP(sizeof(size_t))
+
+//	Provided by strbuf.c
+	extern strbuf_allocator_t strbuf_default_allocator;
+
+	typedef struct strbuf_arena_chunk_t
+	{
+		struct strbuf_arena_chunk_t* prev;
+		size_t size;
+		size_t used;
+		char data[] __attribute__ ((aligned));
+	} strbuf_arena_chunk_t;
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void* arena_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+	static void* arena_alloc(strbuf_arena_t* arena, size_t size);
+	static void* arena_realloc(strbuf_arena_t* arena, void* ptr, size_t size);
+	static void arena_free(strbuf_arena_t* arena, void* ptr);
+	static bool add_chunk(strbuf_arena_t* arena, size_t size_needed);
+	static void free_chunks_until(strbuf_arena_t* arena, strbuf_arena_chunk_t* keep);
+	static size_t* header_of(void* ptr);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strbuf_arena_init(strbuf_arena_t* arena, size_t chunk_size, strbuf_allocator_t* backing)
+{
+	if(!backing)
+		backing = &strbuf_default_allocator;
+
+	arena->allocator = (strbuf_allocator_t){.allocator = arena_allocfunc, .app_data = arena};
+	arena->backing = *backing;
+	arena->chunk_size = chunk_size ? chunk_size : STRBUF_ARENA_CHUNK_SIZE;
+	arena->chunk = NULL;
+	arena->last = NULL;
+	arena->pinned = NULL;
+}
+
+strbuf_arena_mark_t strbuf_arena_mark(strbuf_arena_t* arena)
+{
+	strbuf_arena_mark_t mark = {.chunk = arena->chunk, .used = 0, .last = arena->last};
+	if(arena->chunk)
+		mark.used = arena->chunk->used;
+
+	// the allocation before the mark may grow in place past it, so it is never given back, to leave it's size readable on release
+	arena->pinned = arena->last;
+	return mark;
+}
+
+void strbuf_arena_release(strbuf_arena_t* arena, strbuf_arena_mark_t mark)
+{
+	size_t end;
+
+	if(mark.chunk)
+	{
+		free_chunks_until(arena, mark.chunk);
+		arena->chunk->used = mark.used;
+
+		// keep the allocation before the mark, including anything it has grown by in place
+		if(mark.last)
+		{
+			end = (char*)mark.last - arena->chunk->data + ALIGN_UP(*header_of(mark.last));
+			if(end > mark.used)
+				arena->chunk->used = end;
+		};
+		arena->last = mark.last;
+		arena->pinned = mark.last;
+	}
+	else
+		strbuf_arena_reset(arena);
+}
+
+void strbuf_arena_reset(strbuf_arena_t* arena)
+{
+	strbuf_arena_chunk_t* oldest = arena->chunk;
+
+	while(oldest && oldest->prev)
+		oldest = oldest->prev;
+
+	if(oldest)
+	{
+		free_chunks_until(arena, oldest);
+		oldest->used = 0;
+	};
+	arena->last = NULL;
+	arena->pinned = NULL;
+}
+
+void strbuf_arena_destroy(strbuf_arena_t* arena)
+{
+	free_chunks_until(arena, NULL);
+	arena->last = NULL;
+	arena->pinned = NULL;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static void* arena_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size)
+{
+	strbuf_arena_t* arena = this_allocator->app_data;
+	void* result = NULL;
+
+	if(size == 0)
+		arena_free(arena, ptr_to_free);
+	else if(ptr_to_free)
+		result = arena_realloc(arena, ptr_to_free, size);
+	else
+		result = arena_alloc(arena, size);
+
+	return result;
+}
+
+static void* arena_alloc(strbuf_arena_t* arena, size_t size)
+{
+	void* result = NULL;
+	size_t space_needed = HEADER_SIZE + ALIGN_UP(size);
+	strbuf_arena_chunk_t* chunk = arena->chunk;
+	bool failed = space_needed < size;	// overflow
+
+	if(!failed && !(chunk && chunk->size - chunk->used >= space_needed))
+	{
+		failed = !add_chunk(arena, space_needed);
+		chunk = arena->chunk;
+	};
+
+	if(!failed)
+	{
+		result = &chunk->data[chunk->used + HEADER_SIZE];
+		chunk->used += space_needed;
+		*header_of(result) = size;
+		arena->last = result;
+	};
+
+	return result;
+}
+
+static void* arena_realloc(strbuf_arena_t* arena, void* ptr, size_t size)
+{
+	void* result = NULL;
+	strbuf_arena_chunk_t* chunk = arena->chunk;
+	size_t space_needed = HEADER_SIZE + ALIGN_UP(size);
+	size_t offset;
+
+	// the most recent allocation can be resized in place, if the chunk has room
+	if(ptr == arena->last && chunk && space_needed >= size)
+	{
+		offset = (char*)ptr - chunk->data - HEADER_SIZE;
+		if(chunk->size - offset >= space_needed)
+		{
+			chunk->used = offset + space_needed;
+			*header_of(ptr) = size;
+			result = ptr;
+		};
+	};
+
+	if(!result)
+	{
+		result = arena_alloc(arena, size);
+		if(result)
+		{
+			memcpy(result, ptr, *header_of(ptr) < size ? *header_of(ptr) : size);
+			arena_free(arena, ptr);
+		};
+	};
+
+	return result;
+}
+
+static void arena_free(strbuf_arena_t* arena, void* ptr)
+{
+	// only the most recent allocation can be given back, unless it is pinned by a mark, and none exists after the arena is destroyed
+	if(ptr && ptr == arena->last && arena->chunk)
+	{
+		if(ptr != arena->pinned)
+			arena->chunk->used = (char*)ptr - arena->chunk->data - HEADER_SIZE;
+		arena->last = NULL;
+	};
+}
+
+static bool add_chunk(strbuf_arena_t* arena, size_t size_needed)
+{
+	strbuf_arena_chunk_t* chunk = NULL;
+	size_t size = arena->chunk_size > size_needed ? arena->chunk_size : size_needed;
+
+	if(arena->backing.allocator && sizeof(strbuf_arena_chunk_t) + size > size)
+		chunk = arena->backing.allocator(&arena->backing, NULL, sizeof(strbuf_arena_chunk_t) + size);
+
+	if(chunk)
+	{
+		chunk->prev = arena->chunk;
+		chunk->size = size;
+		chunk->used = 0;
+		arena->chunk = chunk;
+	};
+
+	return !!chunk;
+}
+
+//	free chunks, newest first, until the chunk keep is current. keep may be NULL to free all chunks.
+static void free_chunks_until(strbuf_arena_t* arena, strbuf_arena_chunk_t* keep)
+{
+	strbuf_arena_chunk_t* chunk;
+
+	while(arena->chunk && arena->chunk != keep)
+	{
+		chunk = arena->chunk;
+		arena->chunk = chunk->prev;
+		arena->backing.allocator(&arena->backing, chunk, 0);
+	};
+}
+
+static size_t* header_of(void* ptr)
+{
+	return (size_t*)((char*)ptr - HEADER_SIZE);
+}
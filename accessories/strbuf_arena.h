@@ -0,0 +1,117 @@
+/**
+ * @file strbuf_arena.h
+ * @brief An accessory to strbuf.h providing an arena (bump) allocator.
+ * @author Michael Clift
+ *
+ * Memory is taken from large chunks by advancing an offset, so creating and growing buffers is usually just a pointer bump.
+ * A buffer which is the most recent allocation may grow or shrink in place.
+ * Freeing memory has no effect, unless it is the most recent allocation.
+ * Memory is recovered all at once, either by strbuf_arena_release() to a previous mark, or by strbuf_arena_reset().
+ * Buffers in the recovered memory are simply forgotten, they must not be destroyed afterwards, as their memory may already belong to new buffers.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_arena_t arena;
+ * strbuf_arena_init(&arena, 0, NULL);
+ *
+ * strbuf_arena_mark_t mark = strbuf_arena_mark(&arena);
+ * strbuf_t* buf = strbuf_create(0, &arena.allocator);
+ * strbuf_append(&buf, cstr("Hello"));
+ * strbuf_arena_release(&arena, mark);	// buf no longer exists
+ *
+ * strbuf_arena_destroy(&arena);
+ * @endcode
+ *
+ * ## Build options
+ * -DSTRBUF_ARENA_CHUNK_SIZE=[size]
+ * The chunk size used when 0 is passed to strbuf_arena_init(). Defaults to 16384.
+ *
+ */
+
+#ifndef _STRBUF_ARENA_H_
+	#define _STRBUF_ARENA_H_
+
+	#include <stddef.h>
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#ifndef STRBUF_ARENA_CHUNK_SIZE
+		#define STRBUF_ARENA_CHUNK_SIZE	16384
+	#endif
+
+/**
+ * @struct strbuf_arena_t
+ * @brief An arena instance. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strbuf_arena_t
+	{
+		strbuf_allocator_t allocator;		///< The allocator to pass to strbuf_create(). It's app_data refers to this arena.
+		strbuf_allocator_t backing;			///< The allocator used to obtain chunks.
+		size_t chunk_size;					///< Size of each chunk, larger allocations receive a chunk of their own.
+		struct strbuf_arena_chunk_t* chunk;	///< The current chunk, which links to previous chunks.
+		void* last;							///< The most recent allocation, which may be resized in place, or NULL.
+		void* pinned;						///< The most recent allocation when a mark was taken or released, which is never given back before the next release.
+	} strbuf_arena_t;
+
+/**
+ * @struct strbuf_arena_mark_t
+ * @brief A position within an arena, which can be returned to with strbuf_arena_release().
+ **********************************************************************************/
+	typedef struct strbuf_arena_mark_t
+	{
+		struct strbuf_arena_chunk_t* chunk;
+		size_t used;
+		void* last;
+	} strbuf_arena_mark_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Initialize an arena.
+ * @param arena The arena to initialize.
+ * @param chunk_size The size of memory to request from the backing allocator at a time, or 0 for STRBUF_ARENA_CHUNK_SIZE.
+ * @param backing The allocator used to obtain chunks, or NULL to use the default allocator.
+ * @note No memory is requested until the first allocation.
+ * @note Buffers are created from the arena by passing &arena->allocator to strbuf_create().
+ **********************************************************************************/
+	void strbuf_arena_init(strbuf_arena_t* arena, size_t chunk_size, strbuf_allocator_t* backing);
+
+/**
+ * @brief Record the current position of the arena.
+ * @param arena The arena.
+ * @return A mark which may be passed to strbuf_arena_release().
+ **********************************************************************************/
+	strbuf_arena_mark_t strbuf_arena_mark(strbuf_arena_t* arena);
+
+/**
+ * @brief Free everything allocated since a mark was taken.
+ * @param arena The arena.
+ * @param mark A mark previously returned by strbuf_arena_mark().
+ * @note Buffers created after the mark no longer exist, and must not be used or destroyed.
+ * @note A buffer created before the mark, which has grown in place since, is kept. One which had to move to grow is now in memory allocated after the mark, so no longer exists.
+ * @note Marks taken after this mark become invalid.
+ **********************************************************************************/
+	void strbuf_arena_release(strbuf_arena_t* arena, strbuf_arena_mark_t mark);
+
+/**
+ * @brief Free everything allocated from the arena.
+ * @param arena The arena.
+ * @note All buffers created from the arena no longer exist. Their pointers must be discarded, they must not be used, or passed to strbuf_destroy().
+ * @note One chunk is retained for re-use, to free all memory use strbuf_arena_destroy().
+ **********************************************************************************/
+	void strbuf_arena_reset(strbuf_arena_t* arena);
+
+/**
+ * @brief Return all chunks to the backing allocator.
+ * @param arena The arena.
+ * @note As with strbuf_arena_reset(), all buffers created from the arena no longer exist, and must not be used or destroyed.
+ * @note The arena may be used again after this, and will request new chunks as needed.
+ **********************************************************************************/
+	void strbuf_arena_destroy(strbuf_arena_t* arena);
+
+#endif
@@ -0,0 +1,905 @@
+/*
+*/
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include <stddef.h>
+	#include <limits.h>
+	#include <string.h>
+	#include "strbuf_fmt.h"
+	#include "strbuf.h"
+	#include "strnum.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Provided by strbuf.c
+	extern strbuf_allocator_t strbuf_default_allocator;
+
+	typedef enum op_type_t
+	{
+		OP_LITERAL,
+		OP_SIGNED,
+		OP_UNSIGNED,
+		OP_POINTER,
+		OP_DOUBLE,
+		OP_CHAR,
+		OP_STRING
+	} op_type_t;
+
+//	The type an integer argument was passed as, from the length modifier
+	typedef enum arg_size_t
+	{
+		ARG_INT,
+		ARG_CHAR,
+		ARG_SHORT,
+		ARG_LONG,
+		ARG_LLONG,
+		ARG_SIZE,
+		ARG_INTMAX,
+		ARG_PTRDIFF
+	} arg_size_t;
+
+	typedef struct fmt_op_t
+	{
+		op_type_t type;
+		arg_size_t arg_size;
+		bool left;				// left justify
+		bool width_arg;			// the width is taken from the arguments
+		bool precision_arg;		// the precision is taken from the arguments
+		char sign;				// '+' or ' ' to precede a number which is not negative, or 0
+		int width;
+		int precision;			// or -1 if none
+		int options;			// STRNUM_x flags
+		int literal_start;		// position of literal text within fmt->text
+		int literal_size;
+	} fmt_op_t;
+
+	struct strbuf_fmt_t
+	{
+		strbuf_allocator_t allocator;
+		int count;
+		char* text;				// literal text, which follows the ops
+		fmt_op_t ops[];
+	};
+
+#ifndef STRNUM_NOFLOAT
+//	The exact value of a double, as a decimal integer of base 1e9 words scaled by 10^-frac_digits.
+//	The largest, 2^53 * 5^1074, has 767 digits.
+	#define DECIMAL_BASE	1000000000
+	#define DECIMAL_WORDS	90
+
+	typedef struct decimal_t
+	{
+		uint32_t word[DECIMAL_WORDS];	// least significant first
+		int count;						// the number of words in use, 0 for zero
+		int frac_digits;				// the number of digits after the decimal point
+	} decimal_t;
+#endif
+
+//	An argument, and the width and precision which apply to it
+	typedef struct fmt_arg_t
+	{
+		int width;
+		int precision;
+		union
+		{
+			long long i;
+			unsigned long long u;
+			double d;
+			char c;
+			const char* s;
+		};
+	} fmt_arg_t;
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static bool parse_format(const char* format, strbuf_fmt_t* fmt, int* op_count, int* text_size);
+	static const char* parse_conversion(const char* format, fmt_op_t* op);
+	static const char* parse_int(const char* format, int* value);
+	static void get_arg(const fmt_op_t* op, va_list* va, fmt_arg_t* arg);
+	static long long op_size(const strbuf_fmt_t* fmt, const fmt_op_t* op, const fmt_arg_t* arg);
+	static long long write_op(const strbuf_fmt_t* fmt, const fmt_op_t* op, const fmt_arg_t* arg, char* dst, int dst_size);
+	static int format_signed(char* dst, int dst_size, char sign, unsigned long long value, int width, int options);
+	static int write_padded(char* dst, const char* src, int size, int width);
+	static char* write_field_start(char* dst, char sign, int size, int width, bool zeropad);
+	static void write_field_end(char* dst, int size, int width);
+	static long long field_size(long long size, int width);
+	static int string_size(const fmt_arg_t* arg);
+#ifndef STRNUM_NOFLOAT
+	static long long format_double(char* dst, int dst_size, double value, char sign, int precision, int width, int options);
+	static void decimal_of(decimal_t* dec, uint64_t significand, int exponent);
+	static void decimal_mul(decimal_t* dec, uint32_t factor);
+	static void decimal_round(decimal_t* dec, long long position);
+	static int decimal_exponent(const decimal_t* dec);
+	static int decimal_digit(const decimal_t* dec, long long position);
+#endif
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+strbuf_fmt_t* strbuf_fmt_compile(const char* format, strbuf_allocator_t* allocator)
+{
+	strbuf_fmt_t* fmt = NULL;
+	int op_count;
+	int text_size;
+
+	if(!allocator)
+		allocator = &strbuf_default_allocator;
+
+	if(format && parse_format(format, NULL, &op_count, &text_size))
+		fmt = allocator->allocator(allocator, NULL, sizeof(strbuf_fmt_t) + op_count * sizeof(fmt_op_t) + text_size);
+
+	if(fmt)
+	{
+		fmt->allocator = *allocator;
+		fmt->count = op_count;
+		fmt->text = (char*)&fmt->ops[op_count];
+		parse_format(format, fmt, &op_count, &text_size);
+	};
+
+	return fmt;
+}
+
+void strbuf_fmt_destroy(strbuf_fmt_t** fmt_ptr)
+{
+	strbuf_fmt_t* fmt;
+
+	if(fmt_ptr && *fmt_ptr)
+	{
+		fmt = *fmt_ptr;
+		fmt->allocator.allocator(&fmt->allocator, fmt, 0);
+		*fmt_ptr = NULL;
+	};
+}
+
+strview_t strbuf_fmt_append(strbuf_t** buf_ptr, const strbuf_fmt_t* fmt, ...)
+{
+	strview_t str;
+	va_list va;
+	va_start(va, fmt);
+	str = strbuf_fmt_vappend(buf_ptr, fmt, va);
+	va_end(va);
+	return str;
+}
+
+strview_t strbuf_fmt_vappend(strbuf_t** buf_ptr, const strbuf_fmt_t* fmt, va_list va)
+{
+	va_list args;
+	fmt_arg_t arg;
+	long long total = 0;
+	char* space = NULL;
+	int written = 0;
+	int i;
+
+	if(buf_ptr && *buf_ptr && fmt)
+	{
+		// measure the output, only floating point values need to be converted for this
+		va_copy(args, va);
+		for(i = 0; i < fmt->count && total <= INT_MAX; i++)
+		{
+			get_arg(&fmt->ops[i], &args, &arg);
+			total += op_size(fmt, &fmt->ops[i], &arg);
+		};
+		va_end(args);
+
+		if(total <= INT_MAX)
+			space = strbuf_reserve(buf_ptr, total);
+
+		// write it directly into the buffer
+		if(space)
+		{
+			va_copy(args, va);
+			for(i = 0; i < fmt->count; i++)
+			{
+				get_arg(&fmt->ops[i], &args, &arg);
+				written += write_op(fmt, &fmt->ops[i], &arg, &space[written], total - written + 1);
+			};
+			va_end(args);
+			strbuf_commit(buf_ptr, written);
+		}
+		else
+			strbuf_assign(buf_ptr, cstr(""));
+	};
+
+	return strbuf_view(buf_ptr);
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	Parse the format, counting the ops and literal text needed. If fmt is not NULL, the ops and text are also written to it.
+//	Returns false if the format is not supported.
+static bool parse_format(const char* format, strbuf_fmt_t* fmt, int* op_count, int* text_size)
+{
+	fmt_op_t scratch;
+	fmt_op_t* op = NULL;
+	bool valid = true;
+	int count = 0;
+	int size = 0;
+
+	while(valid && *format)
+	{
+		if(*format != '%' || format[1] == '%')
+		{
+			// consecutive literal characters, including %%, are a single op
+			if(!op || op->type != OP_LITERAL)
+			{
+				op = fmt ? &fmt->ops[count] : &scratch;
+				*op = (fmt_op_t){.type = OP_LITERAL, .literal_start = size};
+				count++;
+			};
+			if(fmt)
+				fmt->text[size] = *format;
+			op->literal_size++;
+			size++;
+			format += (*format == '%') ? 2 : 1;
+		}
+		else
+		{
+			op = fmt ? &fmt->ops[count] : &scratch;
+			format = parse_conversion(format + 1, op);
+			valid = format != NULL;
+			count++;
+		};
+	};
+
+	*op_count = count;
+	*text_size = size;
+	return valid;
+}
+
+//	Parse a conversion following the %. Returns the position following it, or NULL if it is not supported.
+static const char* parse_conversion(const char* format, fmt_op_t* op)
+{
+	bool valid = true;
+	bool done = false;
+	bool hash = false;
+
+	*op = (fmt_op_t){.precision = -1};
+
+	while(!done)
+	{
+		if(*format == '-')
+			op->left = true;
+		else if(*format == '0')
+			op->options |= STRNUM_ZEROPAD;
+		else if(*format == '#')
+			hash = true;
+		else if(*format == '+')
+			op->sign = '+';
+		else if(*format == ' ' && !op->sign)
+			op->sign = ' ';
+		else
+			done = true;
+		if(!done)
+			format++;
+	};
+
+	if(*format == '*')
+	{
+		op->width_arg = true;
+		format++;
+	}
+	else
+		format = parse_int(format, &op->width);
+
+	if(format && *format == '.')
+	{
+		format++;
+		if(*format == '*')
+		{
+			op->precision_arg = true;
+			format++;
+		}
+		else
+			format = parse_int(format, &op->precision);
+	};
+
+	if(!format)
+		valid = false;
+	else if(format[0] == 'h' && format[1] == 'h')
+	{
+		op->arg_size = ARG_CHAR;
+		format += 2;
+	}
+	else if(format[0] == 'l' && format[1] == 'l')
+	{
+		op->arg_size = ARG_LLONG;
+		format += 2;
+	}
+	else if(*format == 'h')
+	{
+		op->arg_size = ARG_SHORT;
+		format++;
+	}
+	else if(*format == 'l')
+	{
+		op->arg_size = ARG_LONG;
+		format++;
+	}
+	else if(*format == 'z')
+	{
+		op->arg_size = ARG_SIZE;
+		format++;
+	}
+	else if(*format == 'j')
+	{
+		op->arg_size = ARG_INTMAX;
+		format++;
+	}
+	else if(*format == 't')
+	{
+		op->arg_size = ARG_PTRDIFF;
+		format++;
+	};
+
+	if(valid)
+	{
+		switch(*format)
+		{
+			case 'd':
+			case 'i':
+				op->type = OP_SIGNED;
+				break;
+			case 'u':
+				op->type = OP_UNSIGNED;
+				break;
+			case 'x':
+				op->type = OP_UNSIGNED;
+				op->options |= STRNUM_BASE_HEX;
+				break;
+			case 'X':
+				op->type = OP_UNSIGNED;
+				op->options |= STRNUM_BASE_HEX | STRNUM_UPPER;
+				break;
+			case 'b':
+				op->type = OP_UNSIGNED;
+				op->options |= STRNUM_BASE_BIN;
+				break;
+			case 'p':
+				op->type = OP_POINTER;
+				op->options |= STRNUM_BASE_HEX | STRNUM_PREFIX;
+				valid = op->arg_size == ARG_INT;
+				break;
+			case 'c':
+				op->type = OP_CHAR;
+				valid = op->arg_size == ARG_INT;
+				break;
+			case 's':
+				op->type = OP_STRING;
+				valid = op->arg_size == ARG_INT;
+				break;
+#ifndef STRNUM_NOFLOAT
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+				op->type = OP_DOUBLE;
+				if(*format == 'f' || *format == 'F')
+					op->options |= STRNUM_NOEXP;
+				else if(*format == 'e' || *format == 'E')
+					op->options |= STRNUM_SCI;
+				if(*format == 'F' || *format == 'E' || *format == 'G')
+					op->options |= STRNUM_UPPER;
+				valid = op->arg_size == ARG_INT || op->arg_size == ARG_LONG;
+				break;
+#endif
+			default:
+				valid = false;
+				break;
+		};
+		format++;
+	};
+
+	// a precision is only supported for strings and floating point, a prefix only for hex and binary,
+	// a sign only for signed and floating point, and zero padding only for numbers
+	if(valid && (op->precision >= 0 || op->precision_arg) && op->type != OP_STRING && op->type != OP_DOUBLE)
+		valid = false;
+	if(valid && op->sign && op->type != OP_SIGNED && op->type != OP_DOUBLE)
+		valid = false;
+	if(valid && hash)
+	{
+		valid = op->options & (STRNUM_BASE_HEX | STRNUM_BASE_BIN);
+		op->options |= STRNUM_PREFIX;
+	};
+	if(valid && (op->options & STRNUM_ZEROPAD) && (op->type == OP_CHAR || op->type == OP_STRING))
+		valid = false;
+
+	return valid ? format : NULL;
+}
+
+//	Parse an optional decimal number. Returns the position following it, or NULL if it is out of range.
+static const char* parse_int(const char* format, int* value)
+{
+	int result = 0;
+
+	while(format && *format >= '0' && *format <= '9')
+	{
+		if(result > (INT_MAX - 9) / 10)
+			format = NULL;
+		else
+			result = result * 10 + (*format++ - '0');
+	};
+
+	*value = result;
+	return format;
+}
+
+//	Take the width, precision and value of an op from the arguments
+static void get_arg(const fmt_op_t* op, va_list* va, fmt_arg_t* arg)
+{
+	arg->width = op->width_arg ? va_arg(*va, int) : op->width;
+	arg->precision = op->precision_arg ? va_arg(*va, int) : op->precision;
+
+	// a negative width from the arguments also means left justify, as for printf
+	if(arg->width < 0)
+		arg->width = arg->width == INT_MIN ? -INT_MAX : arg->width;
+	else if(op->left)
+		arg->width = -arg->width;
+
+	switch(op->type)
+	{
+		case OP_SIGNED:
+			switch(op->arg_size)
+			{
+				case ARG_CHAR:		arg->i = (signed char)va_arg(*va, int);		break;
+				case ARG_SHORT:		arg->i = (short)va_arg(*va, int);			break;
+				case ARG_LONG:		arg->i = va_arg(*va, long);					break;
+				case ARG_LLONG:		arg->i = va_arg(*va, long long);			break;
+				case ARG_SIZE:		arg->i = va_arg(*va, ptrdiff_t);			break;	// the signed type of the same size as size_t
+				case ARG_INTMAX:	arg->i = va_arg(*va, intmax_t);				break;
+				case ARG_PTRDIFF:	arg->i = va_arg(*va, ptrdiff_t);			break;
+				default:			arg->i = va_arg(*va, int);					break;
+			};
+			break;
+
+		case OP_UNSIGNED:
+			switch(op->arg_size)
+			{
+				case ARG_CHAR:		arg->u = (unsigned char)va_arg(*va, unsigned int);		break;
+				case ARG_SHORT:		arg->u = (unsigned short)va_arg(*va, unsigned int);	break;
+				case ARG_LONG:		arg->u = va_arg(*va, unsigned long);					break;
+				case ARG_LLONG:		arg->u = va_arg(*va, unsigned long long);				break;
+				case ARG_SIZE:		arg->u = va_arg(*va, size_t);							break;
+				case ARG_INTMAX:	arg->u = va_arg(*va, uintmax_t);						break;
+				case ARG_PTRDIFF:	arg->u = (size_t)va_arg(*va, ptrdiff_t);				break;
+				default:			arg->u = va_arg(*va, unsigned int);						break;
+			};
+			break;
+
+		case OP_POINTER:
+			arg->u = (uintptr_t)va_arg(*va, void*);
+			break;
+
+		case OP_DOUBLE:
+			arg->d = va_arg(*va, double);
+			break;
+
+		case OP_CHAR:
+			arg->c = va_arg(*va, int);
+			break;
+
+		case OP_STRING:
+			arg->s = va_arg(*va, const char*);
+			if(!arg->s)
+				arg->s = "(null)";
+			break;
+
+		default:
+			break;
+	};
+}
+
+//	The number of characters an op will write
+static long long op_size(const strbuf_fmt_t* fmt, const fmt_op_t* op, const fmt_arg_t* arg)
+{
+	return write_op(fmt, op, arg, NULL, 0);
+}
+
+//	Write an op to dst if it fits within dst_size, including a terminator. Returns the number of characters needed.
+//	If dst is NULL, the size is only measured.
+static long long write_op(const strbuf_fmt_t* fmt, const fmt_op_t* op, const fmt_arg_t* arg, char* dst, int dst_size)
+{
+	long long size = 0;
+	int width = arg->width < 0 ? -arg->width : arg->width;
+
+	switch(op->type)
+	{
+		case OP_LITERAL:
+			size = op->literal_size;
+			if(dst)
+				memcpy(dst, &fmt->text[op->literal_start], size);
+			break;
+
+		case OP_SIGNED:
+			if(op->sign && arg->i >= 0)
+				size = format_signed(dst, dst_size, op->sign, arg->i, arg->width, op->options);
+			else
+				size = strnum_format_llong(dst, dst_size, arg->i, arg->width, op->options);
+			break;
+
+		case OP_UNSIGNED:
+		case OP_POINTER:
+			size = strnum_format_ullong(dst, dst_size, arg->u, arg->width, op->options);
+			break;
+
+#ifndef STRNUM_NOFLOAT
+		case OP_DOUBLE:
+			size = format_double(dst, dst_size, arg->d, op->sign, arg->precision, arg->width, op->options);
+			break;
+#endif
+
+		case OP_CHAR:
+			size = width > 1 ? width : 1;
+			if(dst)
+				write_padded(dst, &arg->c, 1, arg->width);
+			break;
+
+		case OP_STRING:
+			size = string_size(arg);
+			if(dst)
+				size = write_padded(dst, arg->s, size, arg->width);
+			else if(width > size)
+				size = width;
+			break;
+
+		default:
+			break;
+	};
+
+	return size;
+}
+
+//	Format a number which is not negative, preceded by a sign character where strnum would place a minus sign
+static int format_signed(char* dst, int dst_size, char sign, unsigned long long value, int width, int options)
+{
+	char digits[STRNUM_FORMAT_SIZE];
+	int size = strnum_format_ullong(digits, sizeof(digits), value, 0, options & ~STRNUM_ZEROPAD);
+	int field = field_size(size + 1, width);
+	char* pos;
+
+	if(dst && field < dst_size)
+	{
+		pos = write_field_start(dst, sign, size + 1, width, options & STRNUM_ZEROPAD);
+		memcpy(pos, digits, size);
+		write_field_end(pos + size, size + 1, width);
+	}
+	else if(dst && dst_size > 0)
+		dst[0] = 0;
+
+	return field;
+}
+
+//	Write size characters from src, padded with spaces to width (negative to left justify). Returns the number of characters written.
+static int write_padded(char* dst, const char* src, int size, int width)
+{
+	int pad = (width < 0 ? -width : width) - size;
+
+	if(pad < 0)
+		pad = 0;
+
+	if(width > 0)
+		memset(dst, ' ', pad);
+	memcpy(&dst[width > 0 ? pad : 0], src, size);
+	if(width < 0)
+		memset(&dst[size], ' ', pad);
+
+	return size + pad;
+}
+
+//	Write any padding and the sign of a field of size characters, including the sign, padded to width (negative to left justify).
+//	The padding is spaces before the sign, or zeros after it if zeropad. Returns the position for the rest of the field.
+static char* write_field_start(char* dst, char sign, int size, int width, bool zeropad)
+{
+	int pad = width - size;
+
+	if(pad > 0 && !zeropad)
+	{
+		memset(dst, ' ', pad);
+		dst += pad;
+	};
+	if(sign)
+		*dst++ = sign;
+	if(pad > 0 && zeropad)
+	{
+		memset(dst, '0', pad);
+		dst += pad;
+	};
+
+	return dst;
+}
+
+//	Write the padding following a left justified field of size characters, including the sign
+static void write_field_end(char* dst, int size, int width)
+{
+	int pad = -width - size;
+
+	if(pad > 0)
+		memset(dst, ' ', pad);
+}
+
+//	The number of characters in a field of size characters, padded to width
+static long long field_size(long long size, int width)
+{
+	if(width < 0)
+		width = -width;
+	return size > width ? size : width;
+}
+
+//	The length of a string argument, limited by any precision
+static int string_size(const fmt_arg_t* arg)
+{
+	size_t size;
+	const char* end;
+
+	if(arg->precision >= 0)
+	{
+		end = memchr(arg->s, 0, arg->precision);
+		size = end ? (size_t)(end - arg->s) : (size_t)arg->precision;
+	}
+	else
+		size = strlen(arg->s);
+
+	return size > INT_MAX ? INT_MAX : (int)size;
+}
+
+#ifndef STRNUM_NOFLOAT
+//	Format a double as printf would for %f, %e or %g, selected by STRNUM_NOEXP, STRNUM_SCI, or neither.
+//	The digits are taken from the exact value, and rounded to the precision with ties to even.
+static long long format_double(char* dst, int dst_size, double value, char sign, int precision, int width, int options)
+{
+	decimal_t dec;
+	uint64_t bits;
+	uint64_t significand;
+	int exponent;
+	bool upper = options & STRNUM_UPPER;
+	bool zeropad = options & STRNUM_ZEROPAD;
+	const char* special = NULL;
+	bool sci = options & STRNUM_SCI;
+	int exp10 = 0;
+	int magnitude = 0;
+	int int_digits = 1;
+	long long frac_digits = 0;
+	long long size;
+	long long i;
+	char* pos;
+
+	memcpy(&bits, &value, sizeof(bits));
+	exponent = (bits >> 52) & 0x7FF;
+	significand = bits & 0xFFFFFFFFFFFFFULL;
+	if(bits >> 63)
+		sign = '-';
+	if(precision < 0)
+		precision = 6;
+
+	if(exponent == 0x7FF)
+	{
+		special = significand ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+		zeropad = false;
+		size = 3;
+	}
+	else
+	{
+		if(exponent)
+			decimal_of(&dec, significand | (1ULL << 52), exponent - 1075);
+		else
+			decimal_of(&dec, significand, -1074);
+
+		if(options & STRNUM_NOEXP)
+		{
+			decimal_round(&dec, -(long long)precision);
+			frac_digits = precision;
+		}
+		else if(sci)
+		{
+			decimal_round(&dec, (long long)decimal_exponent(&dec) - precision);
+			frac_digits = precision;
+		}
+		else
+		{
+			// precision is the number of significant digits, and the exponent after rounding selects the notation
+			if(!precision)
+				precision = 1;
+			decimal_round(&dec, (long long)decimal_exponent(&dec) - precision + 1);
+			sci = decimal_exponent(&dec) < -4 || decimal_exponent(&dec) >= precision;
+			frac_digits = sci ? precision - 1 : (long long)precision - 1 - decimal_exponent(&dec);
+
+			// trailing zeros are removed, and there are none beyond the exact value
+			if(frac_digits > dec.frac_digits + (sci ? decimal_exponent(&dec) : 0))
+				frac_digits = dec.frac_digits + (sci ? decimal_exponent(&dec) : 0);
+			while(frac_digits > 0 && !decimal_digit(&dec, (sci ? decimal_exponent(&dec) : 0) - frac_digits))
+				frac_digits--;
+		};
+
+		exp10 = decimal_exponent(&dec);
+		magnitude = exp10 < 0 ? -exp10 : exp10;
+		if(!sci && exp10 > 0)
+			int_digits = exp10 + 1;
+		size = int_digits;
+		if(sci)
+			size += 2 + (magnitude < 100 ? 2 : 3);		// e+dd
+		if(frac_digits)
+			size += 1 + frac_digits;
+	};
+
+	size += !!sign;
+
+	if(dst && field_size(size, width) < dst_size)
+	{
+		pos = write_field_start(dst, sign, size, width, zeropad);
+		if(special)
+		{
+			memcpy(pos, special, 3);
+			pos += 3;
+		}
+		else
+		{
+			// with an exponent, there is one integer digit and the positions are relative to it
+			for(i = int_digits - 1; i >= 0; i--)
+				*pos++ = '0' + decimal_digit(&dec, (sci ? exp10 : 0) + i);
+			if(frac_digits)
+				*pos++ = '.';
+			for(i = 1; i <= frac_digits; i++)
+				*pos++ = '0' + decimal_digit(&dec, (sci ? exp10 : 0) - i);
+			if(sci)
+			{
+				*pos++ = upper ? 'E' : 'e';
+				*pos++ = exp10 < 0 ? '-' : '+';
+				if(magnitude >= 100)
+					*pos++ = '0' + magnitude / 100;
+				*pos++ = '0' + magnitude / 10 % 10;
+				*pos++ = '0' + magnitude % 10;
+			};
+		};
+		write_field_end(pos, size, width);
+	}
+	else if(dst && dst_size > 0)
+		dst[0] = 0;
+
+	return field_size(size, width);
+}
+
+//	Convert significand * 2^exponent to an exact decimal
+static void decimal_of(decimal_t* dec, uint64_t significand, int exponent)
+{
+	uint32_t factor;
+
+	dec->count = 0;
+	dec->frac_digits = 0;
+
+	// fewer trailing zero bits means less scaling
+	while(significand && !(significand & 1))
+	{
+		significand >>= 1;
+		exponent++;
+	};
+
+	while(significand)
+	{
+		dec->word[dec->count++] = significand % DECIMAL_BASE;
+		significand /= DECIMAL_BASE;
+	};
+
+	// a fraction m / 2^n has exactly n digits after the point, being m * 5^n / 10^n
+	if(dec->count && exponent < 0)
+		dec->frac_digits = -exponent;
+
+	while(dec->count && exponent > 0)
+	{
+		factor = exponent < 28 ? exponent : 28;
+		exponent -= factor;
+		decimal_mul(dec, (uint32_t)1 << factor);
+	};
+
+	while(dec->count && exponent < 0)
+	{
+		factor = 1;
+		while(exponent < 0 && factor < 1220703125)		// 5^13
+		{
+			factor *= 5;
+			exponent++;
+		};
+		decimal_mul(dec, factor);
+	};
+}
+
+static void decimal_mul(decimal_t* dec, uint32_t factor)
+{
+	uint64_t carry = 0;
+	int i;
+
+	for(i = 0; i < dec->count; i++)
+	{
+		carry += (uint64_t)dec->word[i] * factor;
+		dec->word[i] = carry % DECIMAL_BASE;
+		carry /= DECIMAL_BASE;
+	};
+
+	while(carry)
+	{
+		dec->word[dec->count++] = carry % DECIMAL_BASE;
+		carry /= DECIMAL_BASE;
+	};
+}
+
+//	Round to the nearest multiple of 10^position, with ties to even
+static void decimal_round(decimal_t* dec, long long position)
+{
+	static const uint32_t powers[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+	long long index = position + dec->frac_digits;	// of the lowest digit kept
+	int first_dropped = decimal_digit(dec, position - 1);
+	bool more_dropped = false;
+	bool round_up;
+	uint32_t carry;
+	int i;
+
+	if(index > 0 && index <= (long long)dec->count * 9)
+	{
+		// any non-zero digit after the first dropped one makes it more than half
+		for(i = 0; i < (index - 1) / 9; i++)
+			more_dropped |= !!dec->word[i];
+		more_dropped |= !!(dec->word[(index - 1) / 9] % powers[(index - 1) % 9]);
+		round_up = first_dropped > 5 || (first_dropped == 5 && (more_dropped || decimal_digit(dec, position) % 2));
+
+		for(i = 0; i < index / 9; i++)
+			dec->word[i] = 0;
+		if(i < dec->count)
+			dec->word[i] -= dec->word[i] % powers[index % 9];
+
+		carry = round_up ? powers[index % 9] : 0;
+		while(carry)
+		{
+			if(i == dec->count)
+				dec->word[dec->count++] = 0;
+			dec->word[i] += carry;
+			carry = dec->word[i] / DECIMAL_BASE;
+			dec->word[i++] %= DECIMAL_BASE;
+		};
+
+		while(dec->count && !dec->word[dec->count - 1])
+			dec->count--;
+	}
+	else if(index > 0)
+		dec->count = 0;		// less than half of the lowest digit kept
+}
+
+//	The position of the most significant digit, 0 for the units, or 0 for zero
+static int decimal_exponent(const decimal_t* dec)
+{
+	int digits = 0;
+	uint32_t top;
+
+	if(dec->count)
+	{
+		digits = (dec->count - 1) * 9;
+		for(top = dec->word[dec->count - 1]; top; top /= 10)
+			digits++;
+	};
+
+	return dec->count ? digits - 1 - dec->frac_digits : 0;
+}
+
+//	The digit multiplying 10^position
+static int decimal_digit(const decimal_t* dec, long long position)
+{
+	long long index = position + dec->frac_digits;
+	uint32_t word = 0;
+	int i;
+
+	if(index >= 0 && index / 9 < dec->count)
+	{
+		word = dec->word[index / 9];
+		for(i = index % 9; i; i--)
+			word /= 10;
+	};
+
+	return word % 10;
+}
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file strbuf_fmt.h
+ * @brief An accessory to strbuf.h for repeated formatted output, using format strings compiled in advance.
+ * @author Michael Clift
+ *
+ * A printf style format string is parsed once by strbuf_fmt_compile(), into a list of literal runs and typed conversions.
+ * Appending with the compiled format then needs no parsing. The size of the output is measured first, so the buffer is resized at most once and the text is written directly into it.
+ * Integers and strings are measured without formatting them, but floating point values are converted once to measure them, and again to write them.
+ * Integers are formatted by strnum.h, which must also be compiled.
+ *
+ * Supported conversions are %d %i %u %x %X %b %c %s %p %f %e %g %F %E %G and %%
+ * - The flags - 0 # + and space are supported. # adds a 0x or 0b prefix, + and space precede a signed or floating point value which is not negative.
+ * - The width may be given, or * to take it from the arguments.
+ * - A precision may be given for %s as the maximum number of characters, or for floating point as printf() uses it, or .* to take it from the arguments.
+ * - The length modifiers hh h l ll z j and t are supported.
+ * - Floating point values are written as printf() writes them, with the precision defaulting to 6. They are rounded from their exact value, with ties to even.
+ *   %f writes precision digits after the point, %e writes one digit before and precision digits after the point, followed by an exponent of at least two digits,
+ *   and %g writes precision significant digits in the notation of %f, or of %e for an exponent below -4 or not less than the precision, without trailing zeros.
+ *
+ * Any other conversion, flag, or precision is rejected by strbuf_fmt_compile().
+ * Floating point conversions are also rejected if STRNUM_NOFLOAT is defined.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_fmt_t* fmt = strbuf_fmt_compile("%s: %d items at %g\n", NULL);
+ * strbuf_t* buf = strbuf_create(0, NULL);
+ *
+ * for(int i = 0; i < 3; i++)
+ * 	strbuf_fmt_append(&buf, fmt, "stock", i, 1.25);
+ *
+ * strbuf_fmt_destroy(&fmt);
+ * strbuf_destroy(&buf);
+ * @endcode
+ *
+ */
+
+#ifndef _STRBUF_FMT_H_
+	#define _STRBUF_FMT_H_
+
+	#include <stdarg.h>
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strbuf_fmt_t
+ * @brief A compiled format. The contents are private.
+ **********************************************************************************/
+	typedef struct strbuf_fmt_t strbuf_fmt_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Compile a format string.
+ * @param format The format string, which is copied and need not remain valid.
+ * @param allocator A pointer to a strbuf_allocator_t which provides the allocator to use, or NULL to use the default allocator.
+ * @return The compiled format, or NULL if the format contains an unsupported conversion, or memory could not be allocated.
+ **********************************************************************************/
+	strbuf_fmt_t* strbuf_fmt_compile(const char* format, strbuf_allocator_t* allocator);
+
+/**
+ * @brief Free a compiled format.
+ * @param fmt_ptr The address of a pointer to the compiled format, which will be set to NULL.
+ **********************************************************************************/
+	void strbuf_fmt_destroy(strbuf_fmt_t** fmt_ptr);
+
+/**
+ * @brief Append formatted text to a buffer, using a compiled format.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param fmt The compiled format. If this is NULL nothing is appended.
+ * @param ... The arguments, as for the format string which was compiled.
+ * @return A view of the resulting buffer contents.
+ * @note If the buffer has a fixed capacity which is insufficient, the buffer will be emptied.
+ **********************************************************************************/
+	strview_t strbuf_fmt_append(strbuf_t** buf_ptr, const strbuf_fmt_t* fmt, ...);
+
+/**
+ * @brief non-variadic version of strbuf_fmt_append().
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param fmt The compiled format. If this is NULL nothing is appended.
+ * @param va The arguments, as for the format string which was compiled.
+ * @return A view of the resulting buffer contents.
+ **********************************************************************************/
+	strview_t strbuf_fmt_vappend(strbuf_t** buf_ptr, const strbuf_fmt_t* fmt, va_list va);
+
+#endif
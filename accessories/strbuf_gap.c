@@ -0,0 +1,192 @@
+/*
+*/
+	#include <limits.h>
+	#include <string.h>
+	#include "strbuf_gap.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void move_gap(strbuf_gap_t* gap, int index);
+	static bool grow_gap(strbuf_gap_t* gap, int size_needed);
+	static void sync_buf(strbuf_gap_t* gap);
+	static int clamp_index(strbuf_gap_t* gap, int index);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strbuf_gap_init(strbuf_gap_t* gap, strbuf_t** buf_ptr)
+{
+	gap->buf_ptr = buf_ptr;
+	gap->gap_start = (*buf_ptr)->size;
+	gap->cursor = gap->gap_start;
+	gap->tail = 0;
+}
+
+int strbuf_gap_size(strbuf_gap_t* gap)
+{
+	return gap->gap_start + gap->tail;
+}
+
+int strbuf_gap_set_cursor(strbuf_gap_t* gap, int index)
+{
+	gap->cursor = clamp_index(gap, index);
+	return gap->cursor;
+}
+
+int strbuf_gap_move_cursor(strbuf_gap_t* gap, int offset)
+{
+	int index = gap->cursor;
+
+	if(offset > strbuf_gap_size(gap) - index)
+		index = strbuf_gap_size(gap);
+	else if(offset < -index)
+		index = 0;
+	else
+		index += offset;
+
+	gap->cursor = index;
+	return index;
+}
+
+bool strbuf_gap_insert(strbuf_gap_t* gap, strview_t str)
+{
+	strbuf_t* buf;
+	bool failed = str.size > INT_MAX - strbuf_gap_size(gap);
+
+	if(!failed)
+		failed = !grow_gap(gap, strbuf_gap_size(gap) + str.size);
+
+	if(!failed && str.size)
+	{
+		move_gap(gap, gap->cursor);
+		buf = *gap->buf_ptr;
+		memcpy(&buf->cstr[gap->gap_start], str.data, str.size);
+		gap->gap_start += str.size;
+		gap->cursor = gap->gap_start;
+		sync_buf(gap);
+	}
+	else if(failed)
+	{
+		// empty the buffer, as strbuf.h would
+		gap->gap_start = 0;
+		gap->tail = 0;
+		gap->cursor = 0;
+		sync_buf(gap);
+	};
+
+	return !failed;
+}
+
+int strbuf_gap_delete(strbuf_gap_t* gap, int count)
+{
+	move_gap(gap, gap->cursor);
+
+	if(count >= 0)
+	{
+		if(count > gap->tail)
+			count = gap->tail;
+		gap->tail -= count;
+	}
+	else
+	{
+		count = -count;
+		if(count > gap->gap_start)
+			count = gap->gap_start;
+		gap->gap_start -= count;
+		gap->cursor = gap->gap_start;
+	};
+
+	sync_buf(gap);
+	return count;
+}
+
+strview_t strbuf_gap_view(strbuf_gap_t* gap)
+{
+	move_gap(gap, strbuf_gap_size(gap));
+	return strbuf_view(gap->buf_ptr);
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	Move the gap to index, moving only the characters between the old and new positions
+static void move_gap(strbuf_gap_t* gap, int index)
+{
+	strbuf_t* buf = *gap->buf_ptr;
+	char* tail_start = &buf->cstr[buf->capacity - gap->tail];
+	int distance;
+
+	if(index < gap->gap_start)
+	{
+		distance = gap->gap_start - index;
+		memmove(tail_start - distance, &buf->cstr[index], distance);
+		gap->gap_start -= distance;
+		gap->tail += distance;
+	}
+	else if(index > gap->gap_start)
+	{
+		distance = index - gap->gap_start;
+		memmove(&buf->cstr[gap->gap_start], tail_start, distance);
+		gap->gap_start += distance;
+		gap->tail -= distance;
+	};
+
+	sync_buf(gap);
+}
+
+//	Ensure the capacity is at least size_needed, the tail is moved to the end of the new capacity.
+static bool grow_gap(strbuf_gap_t* gap, int size_needed)
+{
+	strbuf_t* buf = *gap->buf_ptr;
+	int old_capacity = buf->capacity;
+	int new_capacity;
+
+	if(size_needed > old_capacity)
+	{
+		new_capacity = size_needed > INT_MAX - size_needed/2 ? INT_MAX : size_needed + size_needed/2;
+
+		// the whole capacity holds contents while the gap is open, so it must all be kept if the buffer moves
+		buf->size = old_capacity;
+		strbuf_grow(gap->buf_ptr, new_capacity);
+		buf = *gap->buf_ptr;
+
+		if(buf->capacity >= size_needed)
+			memmove(&buf->cstr[buf->capacity - gap->tail], &buf->cstr[old_capacity - gap->tail], gap->tail);
+		sync_buf(gap);
+	};
+
+	return buf->capacity >= size_needed;
+}
+
+//	Keep the buffers size up to date, and terminate it when the gap is at the end
+static void sync_buf(strbuf_gap_t* gap)
+{
+	strbuf_t* buf = *gap->buf_ptr;
+
+	buf->size = strbuf_gap_size(gap);
+	if(!gap->tail)
+		buf->cstr[buf->size] = 0;
+}
+
+static int clamp_index(strbuf_gap_t* gap, int index)
+{
+	int size = strbuf_gap_size(gap);
+
+	if(index > size)
+		index = size;
+	if(index < 0)
+		index += size;
+	if(index < 0)
+		index = 0;
+
+	return index;
+}
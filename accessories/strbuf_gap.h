@@ -0,0 +1,112 @@
+/**
+ * @file strbuf_gap.h
+ * @brief An accessory to strbuf.h for making many small edits around a moving cursor.
+ * @author Michael Clift
+ *
+ * The unused capacity of a buffer is kept as a gap at the cursor position, so inserting or deleting at the cursor does not move the rest of the contents.
+ * Moving the cursor costs nothing until the next edit, which then moves only the characters between the old and new positions.
+ * The gap is closed (moved to the end) only when a contiguous view of the contents is needed, with strbuf_gap_view().
+ *
+ * Works with both dynamic and fixed capacity buffers. As with strbuf.h, if an insert into a buffer of fixed capacity fails due to insufficient capacity, the buffer will be emptied.
+ *
+ * While the gap is open, the buffer must only be accessed through these functions. After strbuf_gap_view() the buffer may be used as normal, but if it is modified by other functions, the strbuf_gap_t must be initialized again before further use.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_t* buf = strbuf_create(cstr("Hello World"), NULL);
+ * strbuf_gap_t gap;
+ *
+ * strbuf_gap_init(&gap, &buf);
+ * strbuf_gap_set_cursor(&gap, 5);
+ * strbuf_gap_insert(&gap, cstr(","));
+ * strbuf_gap_move_cursor(&gap, 1);
+ * strbuf_gap_delete(&gap, 5);
+ * strbuf_gap_insert(&gap, cstr("there"));
+ * printf("%s\n", strbuf_gap_view(&gap).data);	// "Hello, there"
+ *
+ * strbuf_destroy(&buf);
+ * @endcode
+ *
+ */
+
+#ifndef _STRBUF_GAP_H_
+	#define _STRBUF_GAP_H_
+
+	#include <stdbool.h>
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strbuf_gap_t
+ * @brief The state of a gap buffer. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strbuf_gap_t
+	{
+		strbuf_t** buf_ptr;		///< The address of the pointer to the buffer, which is updated if the buffer moves.
+		int cursor;				///< Position of the cursor within the contents.
+		int gap_start;			///< Position of the gap, the contents before the gap are at the start of the buffer.
+		int tail;				///< Size of the contents after the gap, which are at the end of the buffers capacity.
+	} strbuf_gap_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Begin editing a buffer as a gap buffer, with the cursor at the end of it's contents.
+ * @param gap The gap buffer state to initialize.
+ * @param buf_ptr The address of a pointer to the buffer, which must remain valid while the gap buffer is in use.
+ **********************************************************************************/
+	void strbuf_gap_init(strbuf_gap_t* gap, strbuf_t** buf_ptr);
+
+/**
+ * @brief Get the size of the contents.
+ * @param gap The gap buffer.
+ * @return The number of characters held, excluding the gap.
+ **********************************************************************************/
+	int strbuf_gap_size(strbuf_gap_t* gap);
+
+/**
+ * @brief Set the cursor position.
+ * @param gap The gap buffer.
+ * @param index The new position. A negative index is relative to the end of the contents, an index beyond the end is limited to the end.
+ * @return The new cursor position.
+ **********************************************************************************/
+	int strbuf_gap_set_cursor(strbuf_gap_t* gap, int index);
+
+/**
+ * @brief Move the cursor relative to it's current position.
+ * @param gap The gap buffer.
+ * @param offset The number of characters to move, negative to move towards the start. The cursor stops at either end of the contents.
+ * @return The new cursor position.
+ **********************************************************************************/
+	int strbuf_gap_move_cursor(strbuf_gap_t* gap, int offset);
+
+/**
+ * @brief Insert text at the cursor, the cursor is left after the inserted text.
+ * @param gap The gap buffer.
+ * @param str The text to insert, which may not be sourced from the buffer itself.
+ * @return True if successful. False if the buffer could not grow, in which case a fixed capacity buffer is emptied.
+ **********************************************************************************/
+	bool strbuf_gap_insert(strbuf_gap_t* gap, strview_t str);
+
+/**
+ * @brief Delete text at the cursor.
+ * @param gap The gap buffer.
+ * @param count The number of characters after the cursor to delete, or if negative, the number of characters before the cursor to delete.
+ * @return The number of characters deleted.
+ **********************************************************************************/
+	int strbuf_gap_delete(strbuf_gap_t* gap, int count);
+
+/**
+ * @brief Close the gap, and get a view of the buffers contents.
+ * @param gap The gap buffer.
+ * @return A view of the buffer contents, which is also null terminated.
+ * @note The cursor is not moved, and the buffer may continue to be edited through the gap buffer.
+ **********************************************************************************/
+	strview_t strbuf_gap_view(strbuf_gap_t* gap);
+
+#endif
@@ -1,8 +1,10 @@
 /*
 */
+	#define _POSIX_C_SOURCE 200112L
 	#include <limits.h>
 	#include <unistd.h>
 	#include <fcntl.h>
+	#include <sys/stat.h>
 	#include "strbuf_io.h"
 	#include "strbuf.h"
 
@@ -10,7 +12,7 @@
 // Local defines
 //********************************************************************************************************
 
-//	When appending a file to a buffer, start with a buffer of at least this size
+//	When appending a file of unknown size to a buffer, start with a buffer of at least this size
 //	This must be >0 
 	#define MIN_STARTING_SIZE	4096
 
@@ -18,6 +20,8 @@
 // Private prototypes
 //********************************************************************************************************
 
+	static int file_size(int fd);
+
 //********************************************************************************************************
 // Public functions
 //********************************************************************************************************
@@ -72,26 +76,42 @@ strview_t strbuf_append_file(strbuf_t **dst, const char* file_name)
 	int err;
 	bool failed;
 	bool eof = false;
+	bool resized = false;
 	int resize;
+	int size = 0;
 	strview_t retval = STRVIEW_INVALID;
 
 	failed = (dst == NULL || *dst == NULL);
 
-	if(!failed)
-		failed = !strview_is_valid(strbuf_grow(dst, MIN_STARTING_SIZE));
-
 	if(!failed)
 	{
 		fd = open(file_name, O_RDONLY);
 		failed = (fd == -1);
 	};
 
+	if(!failed)
+		size = file_size(fd);
+
+	// a regular file is read into a buffer of it's exact size plus 1, so the read which finds the end of file has space to find it
+	if(!failed && size > 0)
+	{
+		failed = (size > INT_MAX-2 - (*dst)->size);
+		if(!failed)
+			failed = !strview_is_valid(strbuf_grow(dst, (*dst)->size + size + 1));
+		if(!failed)
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+	else if(!failed)
+	{
+		// pipes, devices, and procfs files which report a size of 0, are read by doubling the buffer until the end of file
+		failed = !strview_is_valid(strbuf_grow(dst, MIN_STARTING_SIZE));
+		resized = true;
+	};
+
 	while(!failed && !eof)
 	{
-		err = strbuf_append_read(dst, fd);
-		failed = (err == -1);
-		eof = (err == 0);
-		if(!failed && !eof)
+		// a regular file only fills the buffer if it has grown since it's size was found
+		if((*dst)->size == (*dst)->capacity)
 		{
 			resize = (*dst)->capacity;
 			if(resize < (INT_MAX-2)/2)
@@ -99,16 +119,26 @@ strview_t strbuf_append_file(strbuf_t **dst, const char* file_name)
 			else
 				resize = INT_MAX-1;
 			failed = !(resize > (*dst)->capacity);
+			if(!failed)
+				failed = !strview_is_valid(strbuf_grow(dst, resize));
+			resized = true;
+		};
+
+		if(!failed)
+		{
+			err = strbuf_append_read(dst, fd);
+			failed = (err == -1);
+			eof = (err == 0);
 		};
-		if(!failed && !eof)
-			failed = !strview_is_valid(strbuf_grow(dst, resize));
 	};
 	
 	if(fd != -1)
 		close(fd);
 
-	if(eof)
+	if(eof && resized)
 		retval = strbuf_shrink(dst);
+	else if(eof)
+		retval = strbuf_view(dst);
 	else
 	{
 		strbuf_assign(dst, cstr(""));
@@ -122,3 +152,15 @@ strview_t strbuf_append_file(strbuf_t **dst, const char* file_name)
 // Private functions
 //********************************************************************************************************
 
+//	Return the size of a regular file, or 0 if it is not a regular file or it's size can't be found
+static int file_size(int fd)
+{
+	struct stat st;
+	int size = 0;
+
+	if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+		size = st.st_size > INT_MAX ? INT_MAX : (int)st.st_size;
+
+	return size;
+}
+
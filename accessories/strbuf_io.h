@@ -32,6 +32,7 @@
  * @param buf_ptr The address of a pointer to the buffer.
  * @return The number of bytes written, or -1 for error with errno set.
  * @note The return value is that returned by write(), write() will always be called even if the buffer is empty.
+ * @note The unwritten contents are moved to the start of the buffer after each partial write. To avoid this when writing a large buffer in many parts, use strbuf_stream_write() from strbuf_stream.h
    **********************************************************************************/
 	int strbuf_write(int fd, strbuf_t **buf_ptr);
 
@@ -40,6 +41,8 @@
  * @param buf_ptr The address of a pointer to the target buffer.
  * @return A view of the resulting buffer contents, or STRVIEW_INVALID if the operation failed.
  * @note The buffer will be resized up to a maximum of INT_MAX-1 to allow the entire file to be appended.
+ * @note To send a file to a socket or another file without reading it into a buffer, use strfile_send() or strfile_copy() from strfile.h
+ * @note A regular file is read into a buffer grown once to fit it. Files of unknown size, such as pipes and procfs files, are read by repeatedly doubling the buffer, which is then shrunk to fit.
    **********************************************************************************/
 	strview_t strbuf_append_file(strbuf_t **buf_ptr, const char* file_name);
 
@@ -0,0 +1,135 @@
+/*
+*/
+	#include <stdbool.h>
+	#include <string.h>
+	#include <limits.h>
+	#include "strbuf_lines.h"
+	#include "strbuf_stream.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void skip_eol_pair(strbuf_lines_t* reader);
+	static int find_eol(strview_t str, int start);
+	static strview_t take_line(strbuf_lines_t* reader, int size, int eol_size);
+	static bool fill(strbuf_lines_t* reader);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+bool strbuf_lines_init(strbuf_lines_t* reader, int fd, int capacity, strbuf_allocator_t* allocator)
+{
+	memset(reader, 0, sizeof(strbuf_lines_t));
+	reader->fd = fd;
+	reader->buf = strbuf_create((size_t)(capacity > 0 ? capacity : STRBUF_LINES_READ_SIZE), allocator);
+	strbuf_stream_init(&reader->stream, &reader->buf);
+	return reader->buf != NULL;
+}
+
+void strbuf_lines_destroy(strbuf_lines_t* reader)
+{
+	strbuf_destroy(&reader->buf);
+}
+
+strview_t strbuf_lines_next(strbuf_lines_t* reader)
+{
+	strview_t line = STRVIEW_INVALID;
+	strview_t unconsumed;
+	int index;
+	bool done = false;
+
+	strbuf_stream_consume(&reader->stream, reader->line_size);
+	reader->line_size = 0;
+
+	while(!done)
+	{
+		skip_eol_pair(reader);
+		unconsumed = strbuf_stream_view(&reader->stream);
+		index = find_eol(unconsumed, reader->scanned);
+
+		if(index != -1)
+		{
+			// a pair is one line ending, unless it's second half hasn't been read yet
+			if(index + 1 < unconsumed.size && unconsumed.data[index] + unconsumed.data[index + 1] == '\r'+'\n')
+				line = take_line(reader, index, 2);
+			else
+			{
+				line = take_line(reader, index, 1);
+				if(index + 1 == unconsumed.size)
+					reader->eol = unconsumed.data[index];
+			};
+			done = true;
+		}
+		else
+		{
+			reader->scanned = unconsumed.size;
+			done = !fill(reader);
+			if(done && reader->result == 0 && unconsumed.size)
+				line = take_line(reader, unconsumed.size, 0);		// the last line has no line ending
+		};
+	};
+
+	return line;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	If the previous line ended with the last character read, and the next character completes a CRLF or LFCR pair, consume it
+static void skip_eol_pair(strbuf_lines_t* reader)
+{
+	strview_t unconsumed = strbuf_stream_view(&reader->stream);
+
+	if(reader->eol && unconsumed.size)
+	{
+		if(reader->eol + unconsumed.data[0] == '\r'+'\n')
+			strbuf_stream_consume(&reader->stream, 1);
+		reader->eol = 0;
+	};
+}
+
+//	Return the index of the first CR or LF at or after start, or -1 if there is none
+static int find_eol(strview_t str, int start)
+{
+	const char* ptr = &str.data[start];
+	const char* end = &str.data[str.size];
+
+	while(ptr != end && *ptr != '\r' && *ptr != '\n')
+		ptr++;
+
+	return ptr == end ? -1 : (int)(ptr - str.data);
+}
+
+//	Return a view of the line at the front of the stream, which is consumed with it's line ending by the next call
+static strview_t take_line(strbuf_lines_t* reader, int size, int eol_size)
+{
+	reader->line_size = size + eol_size;
+	reader->scanned = 0;
+	return strview_sub(strbuf_stream_view(&reader->stream), 0, size);
+}
+
+//	Read more into the buffer, growing it first if it's full of unconsumed contents. Return false at the end of the file or for an error.
+static bool fill(strbuf_lines_t* reader)
+{
+	strbuf_t* buf = reader->buf;
+	int capacity;
+
+	if(!reader->stream.head && buf->size == buf->capacity)
+	{
+		capacity = buf->capacity < (INT_MAX-2)/2 ? buf->capacity * 2 : INT_MAX-1;
+		if(capacity > buf->capacity)
+			strbuf_grow(&reader->buf, capacity);
+	};
+
+	reader->result = strbuf_stream_read(&reader->stream, reader->fd);
+
+	return reader->result > 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file strbuf_lines.h
+ * @brief An accessory to strbuf.h for reading a file descriptor line by line.
+ * @author Michael Clift
+ *
+ * The reader owns a buffer which it fills with large reads, and returns each line as a view into that buffer, without copying it.
+ * The buffer is used as a strbuf_stream_t, so returned lines are consumed from the front, and the remaining contents are only moved when the space is needed.
+ * The reader remembers how much of the unconsumed contents it has already searched for a line ending, so each byte is searched only once, however many reads a long line takes.
+ * If a line is longer than the buffer, the buffer is grown to fit it.
+ *
+ * Line endings are handled as strview_split_line() handles them. Any mixture of CR, LF, CRLF and LFCR is accepted, with a CRLF or LFCR pair always being one line ending,
+ * even if the pair is split between two reads. At the end of the file, any remaining text without a line ending is returned as the last line.
+ *
+ * Works with blocking and non-blocking file descriptors. If no complete line is available, an invalid view is returned, and reader.result holds the result of the last read().
+ *
+ * Requires strbuf_stream.c to also be compiled.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_lines_t reader;
+ * strview_t line;
+ *
+ * if(strbuf_lines_init(&reader, fd, 0, NULL))
+ * {
+ * 	line = strbuf_lines_next(&reader);
+ * 	while(strview_is_valid(line))
+ * 	{
+ * 		handle_line(line);
+ * 		line = strbuf_lines_next(&reader);
+ * 	};
+ * 	if(reader.result == -1)
+ * 		perror("read");
+ * 	strbuf_lines_destroy(&reader);
+ * };
+ * @endcode
+ *
+ * ## Build options
+ * -DSTRBUF_LINES_READ_SIZE=[size]
+ * The initial capacity of the buffer, if 0 is given to strbuf_lines_init(). Defaults to 65536.
+ *
+ */
+
+#ifndef _STRBUF_LINES_H_
+	#define _STRBUF_LINES_H_
+
+	#include <stdbool.h>
+	#include "strbuf.h"
+	#include "strbuf_stream.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#ifndef STRBUF_LINES_READ_SIZE
+		#define STRBUF_LINES_READ_SIZE	65536
+	#endif
+
+/**
+ * @struct strbuf_lines_t
+ * @brief The state of a line reader. The members should be treated as read only.
+ * @note The stream refers to the buffer within the reader, so the reader must not be moved or copied while it is in use.
+ **********************************************************************************/
+	typedef struct strbuf_lines_t
+	{
+		strbuf_t* buf;				///< The buffer which is read into.
+		strbuf_stream_t stream;		///< The stream of the buffer, it's unconsumed contents begin with the last line returned.
+		int fd;						///< The file descriptor being read.
+		int scanned;				///< The number of unconsumed characters already searched for a line ending.
+		int line_size;				///< The size of the last line returned, including it's line ending, which is consumed by the next call.
+		char eol;					///< The line ending character if it was the last character read, the state of the eol discriminator for strview_split_line().
+		int result;					///< The result of the last read(), 0 at the end of the file, or -1 for error with errno set.
+	} strbuf_lines_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Initialize a line reader, and create it's buffer.
+ * @param reader The reader to initialize.
+ * @param fd The file descriptor to read from.
+ * @param capacity The initial capacity of the buffer, or 0 for STRBUF_LINES_READ_SIZE. This is the most that is read by each read().
+ * @param allocator A pointer to a strbuf_allocator_t which provides the allocator to use, or NULL to use the default allocator.
+ * @return True if successful, false if the buffer could not be created.
+ **********************************************************************************/
+	bool strbuf_lines_init(strbuf_lines_t* reader, int fd, int capacity, strbuf_allocator_t* allocator);
+
+/**
+ * @brief Destroy the buffer of a line reader. The file descriptor is not closed.
+ * @param reader The reader.
+ **********************************************************************************/
+	void strbuf_lines_destroy(strbuf_lines_t* reader);
+
+/**
+ * @brief Get the next line, reading more from the file descriptor if needed.
+ * @param reader The reader.
+ * @return A view of the line, not including the line ending. If no complete line is available, an invalid view is returned, and reader->result is 0 for the end of the file, or -1 for error with errno set.
+ * @note The view is of the readers buffer, and remains valid until the next call.
+ * @note After an error such as EAGAIN or EINTR, calling again resumes where the reader left off.
+ **********************************************************************************/
+	strview_t strbuf_lines_next(strbuf_lines_t* reader);
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file strbuf_num.h
+ * @brief An accessory to strbuf.h and strnum.h, for appending formatted numbers to a buffer.
+ * @author Michael Clift
+ *
+ * The text is formatted by strnum.h directly into the space following the buffers contents, without a temporary copy or any format string parsing.
+ * All integer types are supported, and float and double unless STRNUM_NOFLOAT is defined, with the options and width described for strnum_format() in strnum.h
+ * Floating point types are written with the fewest digits that convert back to the same value.
+ *
+ * As with strbuf.h, if the buffer is of fixed capacity and the text will not fit, the buffer will be emptied.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_t* buf = strbuf_create(0, NULL);
+ *
+ * strbuf_append_num(&buf, 42, 0, 0);
+ * strbuf_append(&buf, cstr(" = "));
+ * strbuf_append_num(&buf, 42u, 6, STRNUM_BASE_HEX | STRNUM_PREFIX | STRNUM_ZEROPAD);
+ * strbuf_append(&buf, cstr(" "));
+ * strbuf_append_num(&buf, 0.1, 0, 0);
+ * printf("%s\n", buf->cstr);	// "42 = 0x002a 0.1"
+ *
+ * strbuf_destroy(&buf);
+ * @endcode
+ *
+ */
+
+#ifndef _STRBUF_NUM_H_
+	#define _STRBUF_NUM_H_
+
+	#include "strbuf.h"
+	#include "strnum.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/// @cond DEV
+#ifndef STRNUM_NOFLOAT
+	#define _STRBUF_NUM_FLOAT_TYPES	float: _strbuf_append_float, double: _strbuf_append_double,
+#else
+	#define _STRBUF_NUM_FLOAT_TYPES
+#endif
+/// @endcond
+
+/**
+ * @brief Append a number of any type to a buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param value The number to append.
+ * @param width The minimum number of characters to append, negative to left justify.
+ * @param options One or more STRNUM_x flags, as for strnum_format().
+ * @return A view of the resulting buffer contents.
+ **********************************************************************************/
+	#define strbuf_append_num(buf_ptr, value, width, options) _Generic((value),\
+		_STRBUF_NUM_FLOAT_TYPES\
+		unsigned char:			_strbuf_append_unsigned,\
+		unsigned short:			_strbuf_append_unsigned,\
+		unsigned int:			_strbuf_append_unsigned,\
+		unsigned long:			_strbuf_append_unsigned,\
+		unsigned long long:		_strbuf_append_unsigned,\
+		char:					_strbuf_append_signed,\
+		signed char:			_strbuf_append_signed,\
+		short:					_strbuf_append_signed,\
+		int:					_strbuf_append_signed,\
+		long:					_strbuf_append_signed,\
+		long long:				_strbuf_append_signed\
+		)(buf_ptr, value, width, options)
+
+/// @cond DEV
+//	Implementation of strbuf_append_num(). The size is measured first, so the text is written only once.
+static inline strview_t _strbuf_append_unsigned(strbuf_t** buf_ptr, unsigned long long value, int width, int options)
+{
+	int size = strnum_format_ullong(NULL, 0, value, width, options);
+	char* space = strbuf_reserve(buf_ptr, size);
+
+	if(space)
+	{
+		strnum_format_ullong(space, size + 1, value, width, options);
+		strbuf_commit(buf_ptr, size);
+	}
+	else
+		strbuf_assign(buf_ptr, cstr(""));
+
+	return strbuf_view(buf_ptr);
+}
+
+static inline strview_t _strbuf_append_signed(strbuf_t** buf_ptr, long long value, int width, int options)
+{
+	int size = strnum_format_llong(NULL, 0, value, width, options);
+	char* space = strbuf_reserve(buf_ptr, size);
+
+	if(space)
+	{
+		strnum_format_llong(space, size + 1, value, width, options);
+		strbuf_commit(buf_ptr, size);
+	}
+	else
+		strbuf_assign(buf_ptr, cstr(""));
+
+	return strbuf_view(buf_ptr);
+}
+
+#ifndef STRNUM_NOFLOAT
+static inline strview_t _strbuf_append_float(strbuf_t** buf_ptr, float value, int width, int options)
+{
+	int size = strnum_format_float(NULL, 0, value, width, options);
+	char* space = strbuf_reserve(buf_ptr, size);
+
+	if(space)
+	{
+		strnum_format_float(space, size + 1, value, width, options);
+		strbuf_commit(buf_ptr, size);
+	}
+	else
+		strbuf_assign(buf_ptr, cstr(""));
+
+	return strbuf_view(buf_ptr);
+}
+
+static inline strview_t _strbuf_append_double(strbuf_t** buf_ptr, double value, int width, int options)
+{
+	int size = strnum_format_double(NULL, 0, value, width, options);
+	char* space = strbuf_reserve(buf_ptr, size);
+
+	if(space)
+	{
+		strnum_format_double(space, size + 1, value, width, options);
+		strbuf_commit(buf_ptr, size);
+	}
+	else
+		strbuf_assign(buf_ptr, cstr(""));
+
+	return strbuf_view(buf_ptr);
+}
+#endif
+/// @endcond
+
+#endif
@@ -0,0 +1,349 @@
+/*
+*/
+	#include <stdlib.h>
+	#include <stdbool.h>
+	#include <string.h>
+	#include <pthread.h>
+	#include "strbuf_pool.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+	#define MIN_BLOCK_SHIFT	5
+	#define CLASS_COUNT		5		// 32, 64, 128, 256, 512
+	#define LARGE_CLASS		(-1)
+
+	_Static_assert((1 << (MIN_BLOCK_SHIFT + CLASS_COUNT - 1)) == STRBUF_POOL_MAX_BLOCK, "size classes must end at STRBUF_POOL_MAX_BLOCK");
+
+	struct pool_cache_t;
+
+//	Precedes every allocation. Sized to keep the allocation aligned as malloc would.
+	typedef union block_t
+	{
+		struct
+		{
+			struct pool_cache_t* owner;		// NULL for large blocks
+			int class;
+		};
+		union block_t* next;				// while on a free list
+	} __attribute__ ((aligned)) block_t;
+
+	typedef struct pool_cache_t
+	{
+		block_t* free[CLASS_COUNT];
+		block_t* remote;					// blocks freed by other threads, pushed atomically
+		struct pool_cache_t* next_orphan;
+
+		// blocks freed by this thread, waiting to be returned to another owner
+		struct pool_cache_t* pending_owner;
+		block_t* pending_head;
+		block_t* pending_tail;
+		int pending_count;
+	} pool_cache_t;
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void* pool_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+	static void* pool_alloc(size_t size);
+	static void* pool_realloc(void* ptr, size_t size);
+	static void pool_free(void* ptr);
+	static int class_of_size(size_t size);
+	static size_t size_of_class(int class);
+	static bool refill(pool_cache_t* cache, int class);
+	static void drain_remote(pool_cache_t* cache);
+	static void queue_remote(pool_cache_t* cache, block_t* block);
+	static void flush_pending(pool_cache_t* cache);
+	static void push_remote(pool_cache_t* owner, block_t* head, block_t* tail);
+	static pool_cache_t* get_cache(void);
+	static void make_key(void);
+	static void thread_exit(void* arg);
+
+//********************************************************************************************************
+// Public variables
+//********************************************************************************************************
+
+	strbuf_allocator_t strbuf_pool_allocator = (strbuf_allocator_t){.allocator=pool_allocfunc, .app_data=NULL};
+
+//********************************************************************************************************
+// Private variables
+//********************************************************************************************************
+
+	static __thread pool_cache_t* thread_cache;
+
+	static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+	static pthread_key_t cache_key;
+
+//	caches of threads which have exited, waiting to be adopted
+	static pthread_mutex_t orphan_lock = PTHREAD_MUTEX_INITIALIZER;
+	static pool_cache_t* orphans;
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strbuf_pool_flush(void)
+{
+	if(thread_cache)
+		flush_pending(thread_cache);
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static void* pool_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size)
+{
+	(void)this_allocator;
+	void* result = NULL;
+
+	if(size == 0)
+		pool_free(ptr_to_free);
+	else if(ptr_to_free)
+		result = pool_realloc(ptr_to_free, size);
+	else
+		result = pool_alloc(size);
+
+	return result;
+}
+
+static void* pool_alloc(size_t size)
+{
+	block_t* block = NULL;
+	pool_cache_t* cache;
+	int class = class_of_size(size);
+
+	if(class == LARGE_CLASS)
+	{
+		if(sizeof(block_t) + size > size)
+			block = malloc(sizeof(block_t) + size);
+		if(block)
+		{
+			block->owner = NULL;
+			block->class = LARGE_CLASS;
+		};
+	}
+	else
+	{
+		cache = get_cache();
+		if(cache && !cache->free[class])
+			drain_remote(cache);
+		if(cache && (cache->free[class] || refill(cache, class)))
+		{
+			block = cache->free[class];
+			cache->free[class] = block->next;
+			block->owner = cache;
+			block->class = class;
+		};
+	};
+
+	return block ? block + 1 : NULL;
+}
+
+static void* pool_realloc(void* ptr, size_t size)
+{
+	block_t* block = (block_t*)ptr - 1;
+	void* result = NULL;
+	size_t old_size;
+
+	if(block->class == LARGE_CLASS && class_of_size(size) == LARGE_CLASS)
+	{
+		if(sizeof(block_t) + size > size)
+			block = realloc(block, sizeof(block_t) + size);
+		else
+			block = NULL;
+		result = block ? block + 1 : NULL;
+	}
+	else if(block->class != LARGE_CLASS && class_of_size(size) == block->class)
+		result = ptr;
+	else
+	{
+		result = pool_alloc(size);
+		if(result)
+		{
+			// a large block's size isn't recorded, but it is always larger than any class
+			old_size = block->class == LARGE_CLASS ? size : size_of_class(block->class);
+			memcpy(result, ptr, old_size < size ? old_size : size);
+			pool_free(ptr);
+		};
+	};
+
+	return result;
+}
+
+static void pool_free(void* ptr)
+{
+	block_t* block;
+	pool_cache_t* cache;
+
+	if(ptr)
+	{
+		block = (block_t*)ptr - 1;
+		if(block->class == LARGE_CLASS)
+			free(block);
+		else
+		{
+			cache = get_cache();
+			if(cache == block->owner)
+			{
+				block->next = cache->free[block->class];
+				cache->free[block->class] = block;
+			}
+			else if(cache)
+				queue_remote(cache, block);
+			else
+				push_remote(block->owner, block, block);	// no cache for this thread
+		};
+	};
+}
+
+static int class_of_size(size_t size)
+{
+	int class = 0;
+
+	if(size > STRBUF_POOL_MAX_BLOCK)
+		class = LARGE_CLASS;
+	else
+	{
+		while(size_of_class(class) < size)
+			class++;
+	};
+
+	return class;
+}
+
+static size_t size_of_class(int class)
+{
+	return (size_t)1 << (class + MIN_BLOCK_SHIFT);
+}
+
+//	carve a new slab into blocks of the given class, and put them on the free list
+static bool refill(pool_cache_t* cache, int class)
+{
+	size_t block_size = sizeof(block_t) + size_of_class(class);
+	size_t count = STRBUF_POOL_SLAB_SIZE / block_size;
+	char* slab;
+	block_t* block;
+
+	if(!count)
+		count = 1;
+
+	slab = malloc(count * block_size);
+	if(slab)
+	{
+		while(count--)
+		{
+			block = (block_t*)(slab + count * block_size);
+			block->next = cache->free[class];
+			cache->free[class] = block;
+		};
+	};
+
+	return !!slab;
+}
+
+//	take all blocks returned by other threads in one exchange, and sort them onto the free lists
+static void drain_remote(pool_cache_t* cache)
+{
+	block_t* block = NULL;
+	block_t* next;
+	int class;
+
+	if(__atomic_load_n(&cache->remote, __ATOMIC_RELAXED))
+		block = __atomic_exchange_n(&cache->remote, NULL, __ATOMIC_ACQUIRE);
+
+	while(block)
+	{
+		next = block->next;
+		class = block->class;
+		block->next = cache->free[class];
+		cache->free[class] = block;
+		block = next;
+	};
+}
+
+//	collect blocks for another owner, and return them all at once
+static void queue_remote(pool_cache_t* cache, block_t* block)
+{
+	if(cache->pending_owner != block->owner || cache->pending_count >= STRBUF_POOL_BATCH)
+		flush_pending(cache);
+
+	if(!cache->pending_head)
+	{
+		cache->pending_owner = block->owner;
+		cache->pending_tail = block;
+	};
+
+	// the class is kept in the block, the owner is implied by the list it joins
+	block->next = cache->pending_head;
+	cache->pending_head = block;
+	cache->pending_count++;
+}
+
+static void flush_pending(pool_cache_t* cache)
+{
+	if(cache->pending_head)
+		push_remote(cache->pending_owner, cache->pending_head, cache->pending_tail);
+
+	cache->pending_owner = NULL;
+	cache->pending_head = NULL;
+	cache->pending_tail = NULL;
+	cache->pending_count = 0;
+}
+
+//	push a chain of blocks onto the owner's remote list, with a single exchange
+static void push_remote(pool_cache_t* owner, block_t* head, block_t* tail)
+{
+	tail->next = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+	while(!__atomic_compare_exchange_n(&owner->remote, &tail->next, head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static pool_cache_t* get_cache(void)
+{
+	pool_cache_t* cache = thread_cache;
+
+	if(!cache)
+	{
+		pthread_once(&key_once, make_key);
+
+		pthread_mutex_lock(&orphan_lock);
+		cache = orphans;
+		if(cache)
+			orphans = cache->next_orphan;
+		pthread_mutex_unlock(&orphan_lock);
+
+		if(!cache)
+			cache = calloc(1, sizeof(pool_cache_t));
+
+		if(cache)
+		{
+			cache->next_orphan = NULL;
+			thread_cache = cache;
+			pthread_setspecific(cache_key, cache);
+		};
+	};
+
+	return cache;
+}
+
+static void make_key(void)
+{
+	pthread_key_create(&cache_key, thread_exit);
+}
+
+//	The cache can't be freed, as other threads may still hold blocks it owns. Keep it for the next new thread.
+static void thread_exit(void* arg)
+{
+	pool_cache_t* cache = arg;
+
+	flush_pending(cache);
+	thread_cache = NULL;
+
+	pthread_mutex_lock(&orphan_lock);
+	cache->next_orphan = orphans;
+	orphans = cache;
+	pthread_mutex_unlock(&orphan_lock);
+}
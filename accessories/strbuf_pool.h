@@ -0,0 +1,71 @@
+/**
+ * @file strbuf_pool.h
+ * @brief An accessory to strbuf.h providing a thread caching pool allocator for small buffers.
+ * @author Michael Clift
+ *
+ * Allocations of up to STRBUF_POOL_MAX_BLOCK bytes are served from power-of-two size classes, starting at 32 bytes.
+ * Each thread has it's own free lists, so allocating and freeing on the same thread takes no locks.
+ * A block freed by a thread other than the one which allocated it is queued, and returned to the owning thread in batches.
+ * Larger allocations are passed through to malloc/realloc/free.
+ *
+ * Memory held by the pool is retained for re-use and never returned to the system.
+ * When a thread exits, it's free lists are kept and handed to the next thread which starts using the pool.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_t* buf = strbuf_create(0, &strbuf_pool_allocator);
+ * strbuf_append(&buf, cstr("Hello"));
+ * strbuf_destroy(&buf);	// may be on any thread
+ * @endcode
+ *
+ * Requires linking with -pthread.
+ *
+ * ## Build options
+ * -DSTRBUF_POOL_SLAB_SIZE=[size]
+ * The size of memory obtained from malloc when a size class needs refilling. Defaults to 16384.
+ *
+ * -DSTRBUF_POOL_BATCH=[count]
+ * The number of blocks a thread collects before returning them to another owning thread. Defaults to 32.
+ *
+ */
+
+#ifndef _STRBUF_POOL_H_
+	#define _STRBUF_POOL_H_
+
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#define STRBUF_POOL_MAX_BLOCK	512
+
+	#ifndef STRBUF_POOL_SLAB_SIZE
+		#define STRBUF_POOL_SLAB_SIZE	16384
+	#endif
+
+	#ifndef STRBUF_POOL_BATCH
+		#define STRBUF_POOL_BATCH	32
+	#endif
+
+//********************************************************************************************************
+// Public variables
+//********************************************************************************************************
+
+/**
+ * @brief The pool allocator, pass &strbuf_pool_allocator to strbuf_create() or strbuf_create_empty().
+ **********************************************************************************/
+	extern strbuf_allocator_t strbuf_pool_allocator;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Return any blocks this thread is holding for other threads to their owners.
+ * @note This happens automatically when the thread exits, or when STRBUF_POOL_BATCH blocks have been collected.
+ * @note Call this from a thread which is about to go idle, to make it's pending frees available to other threads.
+ **********************************************************************************/
+	void strbuf_pool_flush(void);
+
+#endif
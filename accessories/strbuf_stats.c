@@ -0,0 +1,192 @@
+/*
+*/
+	#define _POSIX_C_SOURCE 199309L
+	#include <stdbool.h>
+	#include <string.h>
+	#include <time.h>
+	#include "strbuf_stats.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Every allocation is preceded by a header of this size which holds the size requested, keeping the alignment of the backing allocator
+	#define ALIGNMENT		((size_t)__BIGGEST_ALIGNMENT__)
+	#define HEADER_SIZE		((sizeof(size_t) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+//	Provided by strbuf.c
+	extern strbuf_allocator_t strbuf_default_allocator;
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void* stats_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+	static size_t stats_usable_size(struct strbuf_allocator_t* this_allocator, void* ptr);
+	static void record_live(strbuf_stats_t* stats, size_t old_size, size_t new_size);
+	static void record_final_size(strbuf_stats_t* stats, size_t size);
+	static uint64_t now_ns(void);
+	static size_t* header_of(void* ptr);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strbuf_stats_init(strbuf_stats_t* stats, strbuf_allocator_t* backing)
+{
+	if(!backing)
+		backing = &strbuf_default_allocator;
+
+	memset(stats, 0, sizeof(strbuf_stats_t));
+	stats->backing = *backing;
+	stats->allocator = (strbuf_allocator_t){.allocator = stats_allocfunc, .app_data = stats, .growth = backing->growth};
+	if(backing->usable_size)
+		stats->allocator.usable_size = stats_usable_size;
+}
+
+void strbuf_stats_reset(strbuf_stats_t* stats)
+{
+	strbuf_allocator_t allocator = stats->allocator;
+	strbuf_allocator_t backing = stats->backing;
+	uint64_t live_bytes = stats->live_bytes;
+
+	memset(stats, 0, sizeof(strbuf_stats_t));
+	stats->allocator = allocator;
+	stats->backing = backing;
+	stats->live_bytes = live_bytes;
+	stats->peak_live_bytes = live_bytes;
+}
+
+strview_t strbuf_stats_append_text(strbuf_t** buf_ptr, strbuf_stats_t* stats)
+{
+	int i;
+	const struct {const char* name; uint64_t value;} counters[] =
+	{
+		{"allocs", stats->allocs},
+		{"reallocs", stats->reallocs},
+		{"frees", stats->frees},
+		{"failures", stats->failures},
+		{"bytes_requested", stats->bytes_requested},
+		{"bytes_relocated", stats->bytes_relocated},
+		{"live_bytes", stats->live_bytes},
+		{"peak_live_bytes", stats->peak_live_bytes},
+		{"nanoseconds", stats->nanoseconds},
+		{"grows", stats->grows},
+		{"shrinks", stats->shrinks},
+		{"bytes_grown", stats->bytes_grown}
+	};
+
+	for(i = 0; i != sizeof(counters)/sizeof(counters[0]); i++)
+		strbuf_catx(buf_ptr, strbuf_view(buf_ptr), counters[i].name, (char)' ', counters[i].value, (char)'\n');
+
+	for(i = 0; i != STRBUF_STATS_BUCKETS; i++)
+	{
+		if(stats->final_sizes[i] && i + 1 != STRBUF_STATS_BUCKETS)
+			strbuf_catx(buf_ptr, strbuf_view(buf_ptr), "final_size ", 1ULL << i, (char)'-', (1ULL << (i + 1)) - 1, (char)' ', stats->final_sizes[i], (char)'\n');
+		else if(stats->final_sizes[i])
+			strbuf_catx(buf_ptr, strbuf_view(buf_ptr), "final_size ", 1ULL << i, "+ ", stats->final_sizes[i], (char)'\n');
+	};
+
+	return strbuf_view(buf_ptr);
+}
+
+void strbuf_stats_capacity_hook(strbuf_t* buf, int old_capacity)
+{
+	strbuf_stats_t* stats;
+
+	if(buf->allocator.allocator == stats_allocfunc)
+	{
+		stats = buf->allocator.app_data;
+		if(buf->capacity > old_capacity)
+		{
+			stats->grows++;
+			stats->bytes_grown += buf->capacity - old_capacity;
+		}
+		else
+			stats->shrinks++;
+	};
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static void* stats_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size)
+{
+	strbuf_stats_t* stats = this_allocator->app_data;
+	size_t* header = ptr_to_free ? header_of(ptr_to_free) : NULL;
+	size_t old_size = header ? *header : 0;
+	size_t* result = NULL;
+	uint64_t start = now_ns();
+
+	if(size == 0)
+	{
+		stats->backing.allocator(&stats->backing, header, 0);
+		stats->frees++;
+		record_final_size(stats, old_size);
+		record_live(stats, old_size, 0);
+	}
+	else
+	{
+		result = stats->backing.allocator(&stats->backing, header, HEADER_SIZE + size);
+		if(header)
+			stats->reallocs++;
+		else
+			stats->allocs++;
+		stats->bytes_requested += size;
+
+		if(result)
+		{
+			if(header && result != header)
+				stats->bytes_relocated += old_size < size ? old_size : size;
+			*result = size;
+			record_live(stats, old_size, size);
+		}
+		else
+			stats->failures++;
+	};
+
+	stats->nanoseconds += now_ns() - start;
+	return result ? (char*)result + HEADER_SIZE : NULL;
+}
+
+static size_t stats_usable_size(struct strbuf_allocator_t* this_allocator, void* ptr)
+{
+	strbuf_stats_t* stats = this_allocator->app_data;
+	return stats->backing.usable_size(&stats->backing, header_of(ptr)) - HEADER_SIZE;
+}
+
+static void record_live(strbuf_stats_t* stats, size_t old_size, size_t new_size)
+{
+	stats->live_bytes += new_size;
+	stats->live_bytes -= old_size;
+	if(stats->live_bytes > stats->peak_live_bytes)
+		stats->peak_live_bytes = stats->live_bytes;
+}
+
+//	Count the size in bucket n, where 2^n <= size < 2^(n+1)
+static void record_final_size(strbuf_stats_t* stats, size_t size)
+{
+	int bucket = 0;
+
+	while(size > 1 && bucket + 1 != STRBUF_STATS_BUCKETS)
+	{
+		size >>= 1;
+		bucket++;
+	};
+
+	stats->final_sizes[bucket]++;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t* header_of(void* ptr)
+{
+	return (size_t*)((char*)ptr - HEADER_SIZE);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file strbuf_stats.h
+ * @brief An accessory to strbuf.h providing an allocator which records statistics, for tuning initial capacities and growth policies.
+ * @author Michael Clift
+ *
+ * The allocator passes every request on to a backing allocator, and counts the allocations, reallocations and frees,
+ * the bytes requested, the bytes copied when a reallocation moves memory, the live and peak live bytes, and the time spent in the backing allocator.
+ * When memory is freed, it's final size is added to a histogram of power of 2 buckets.
+ *
+ * If strbuf.c is built with -DSTRBUF_CAPACITY_HOOK=strbuf_stats_capacity_hook, each time a buffer using the allocator grows or shrinks, the event is also attributed to it's statistics.
+ *
+ * The statistics are not thread safe. Each thread should use it's own strbuf_stats_t.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_stats_t stats;
+ * strbuf_stats_init(&stats, NULL);
+ *
+ * strbuf_t* buf = strbuf_create(0, &stats.allocator);
+ * ...
+ * strbuf_destroy(&buf);
+ *
+ * strbuf_t* report = strbuf_create(0, NULL);
+ * strbuf_stats_append_text(&report, &stats);
+ * printf("%s", report->cstr);
+ * @endcode
+ *
+ * ## Build options
+ * -DSTRBUF_STATS_BUCKETS=[n]
+ * The number of histogram buckets, bucket n counts sizes from 2^n to 2^(n+1)-1, and the last bucket also counts larger sizes. Defaults to 32.
+ *
+ */
+
+#ifndef _STRBUF_STATS_H_
+	#define _STRBUF_STATS_H_
+
+	#include <stdint.h>
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#ifndef STRBUF_STATS_BUCKETS
+		#define STRBUF_STATS_BUCKETS	32
+	#endif
+
+/**
+ * @struct strbuf_stats_t
+ * @brief An instrumented allocator, and it's statistics. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strbuf_stats_t
+	{
+		strbuf_allocator_t allocator;		///< The allocator to pass to strbuf_create(). It's app_data refers to this structure.
+		strbuf_allocator_t backing;			///< The allocator which requests are passed on to.
+		uint64_t allocs;					///< The number of new allocations.
+		uint64_t reallocs;					///< The number of resized allocations.
+		uint64_t frees;						///< The number of allocations freed.
+		uint64_t failures;					///< The number of allocations or reallocations which the backing allocator failed.
+		uint64_t bytes_requested;			///< The total size requested by allocations and reallocations.
+		uint64_t bytes_relocated;			///< The total size copied by reallocations which moved the memory.
+		uint64_t live_bytes;				///< The size of all allocations not yet freed.
+		uint64_t peak_live_bytes;			///< The largest live_bytes has been.
+		uint64_t nanoseconds;				///< The time spent in the backing allocator.
+		uint64_t grows;						///< The number of times a buffer grew, if strbuf.c is built with -DSTRBUF_CAPACITY_HOOK=strbuf_stats_capacity_hook
+		uint64_t shrinks;					///< The number of times a buffer shrunk, as above.
+		uint64_t bytes_grown;				///< The total capacity added by growing buffers, as above.
+		uint64_t final_sizes[STRBUF_STATS_BUCKETS];	///< A histogram of the sizes of allocations when freed.
+	} strbuf_stats_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Initialize an instrumented allocator, with all statistics zeroed.
+ * @param stats The instance to initialize.
+ * @param backing The allocator to pass requests on to, or NULL to use the default allocator. It's growth policy is also used.
+ * @note Buffers are created with the instrumented allocator by passing &stats->allocator to strbuf_create().
+ **********************************************************************************/
+	void strbuf_stats_init(strbuf_stats_t* stats, strbuf_allocator_t* backing);
+
+/**
+ * @brief Zero the statistics, except live_bytes which still holds the size of allocations not yet freed, and peak_live_bytes which is set to it.
+ * @param stats The instance.
+ **********************************************************************************/
+	void strbuf_stats_reset(strbuf_stats_t* stats);
+
+/**
+ * @brief Append the statistics as text, one "name value" pair per line, followed by a line for each non-empty histogram bucket.
+ * @param buf_ptr The address of a pointer to the buffer to append to, which should not use the instrumented allocator.
+ * @param stats The instance.
+ * @return A view of the resulting buffer contents.
+ **********************************************************************************/
+	strview_t strbuf_stats_append_text(strbuf_t** buf_ptr, strbuf_stats_t* stats);
+
+/**
+ * @brief Attribute a change in the capacity of a buffer to the statistics of it's allocator.
+ * @param buf The buffer.
+ * @param old_capacity It's capacity before the change.
+ * @note This is intended to be called by strbuf.c, when built with -DSTRBUF_CAPACITY_HOOK=strbuf_stats_capacity_hook. Buffers using other allocators are ignored.
+ **********************************************************************************/
+	void strbuf_stats_capacity_hook(strbuf_t* buf, int old_capacity);
+
+#endif
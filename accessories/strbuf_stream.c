@@ -0,0 +1,133 @@
+/*
+*/
+	#include <stdbool.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include "strbuf_stream.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static int unconsumed_size(strbuf_stream_t* stream);
+	static void compact(strbuf_stream_t* stream);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strbuf_stream_init(strbuf_stream_t* stream, strbuf_t** buf_ptr)
+{
+	stream->buf_ptr = buf_ptr;
+	stream->head = 0;
+}
+
+strview_t strbuf_stream_view(strbuf_stream_t* stream)
+{
+	strbuf_t* buf = *stream->buf_ptr;
+	return (strview_t){.data = &buf->cstr[stream->head], .size = unconsumed_size(stream)};
+}
+
+int strbuf_stream_consume(strbuf_stream_t* stream, int count)
+{
+	int size = unconsumed_size(stream);
+
+	if(count > size)
+		count = size;
+	if(count < 0)
+		count = 0;
+
+	stream->head += count;
+
+	if(count == size)
+		compact(stream);	// nothing to move
+	else if(stream->head >= STRBUF_STREAM_COMPACT_SIZE && stream->head >= size - count)
+		compact(stream);
+
+	return count;
+}
+
+strview_t strbuf_stream_append(strbuf_stream_t* stream, strview_t str)
+{
+	strbuf_t* buf = *stream->buf_ptr;
+	bool str_in_buf = strview_is_valid(str) && &buf->cstr[stream->head] <= str.data && str.data < &buf->cstr[buf->size];
+	int size = unconsumed_size(stream);
+
+	if(stream->head && str.size > buf->capacity - buf->size && (stream->head >= size || !buf->allocator.allocator))
+	{
+		if(str_in_buf)
+			str.data -= stream->head;
+		compact(stream);
+	};
+
+	strbuf_append(stream->buf_ptr, str);
+	if(!(*stream->buf_ptr)->size)
+		stream->head = 0;	// emptied
+
+	return strbuf_stream_view(stream);
+}
+
+strview_t strbuf_stream_compact(strbuf_stream_t* stream)
+{
+	compact(stream);
+	return strbuf_view(stream->buf_ptr);
+}
+
+int strbuf_stream_read(strbuf_stream_t* stream, int fd)
+{
+	strbuf_t* buf = *stream->buf_ptr;
+	int retval;
+
+	// as for consuming, unless there is no space at all to read into
+	if(buf->size == buf->capacity || (stream->head >= STRBUF_STREAM_COMPACT_SIZE && stream->head >= unconsumed_size(stream)))
+		compact(stream);
+
+	retval = read(fd, &buf->cstr[buf->size], buf->capacity - buf->size);
+	if(retval > 0)
+	{
+		buf->size += retval;
+		buf->cstr[buf->size] = 0;
+	};
+
+	return retval;
+}
+
+int strbuf_stream_write(int fd, strbuf_stream_t* stream)
+{
+	strview_t unconsumed = strbuf_stream_view(stream);
+	int retval = write(fd, unconsumed.data, unconsumed.size);
+
+	if(retval > 0)
+		strbuf_stream_consume(stream, retval);
+
+	return retval;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static int unconsumed_size(strbuf_stream_t* stream)
+{
+	return (*stream->buf_ptr)->size - stream->head;
+}
+
+//	Move the unconsumed contents to the start of the buffer
+static void compact(strbuf_stream_t* stream)
+{
+	strbuf_t* buf = *stream->buf_ptr;
+	int size = unconsumed_size(stream);
+
+	if(stream->head)
+	{
+		memmove(buf->cstr, &buf->cstr[stream->head], size);
+		buf->size = size;
+		buf->cstr[size] = 0;
+		stream->head = 0;
+	};
+}
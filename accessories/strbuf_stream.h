@@ -0,0 +1,121 @@
+/**
+ * @file strbuf_stream.h
+ * @brief An accessory to strbuf.h for buffers which are appended to at the end, and consumed from the front.
+ * @author Michael Clift
+ *
+ * Removing characters from the front of a buffer with strbuf_assign() moves everything which remains, so consuming a large buffer a little at a time takes quadratic time.
+ * A stream instead records how much of the buffer has been consumed. Consuming only advances this offset, and the consumed space is reclaimed later by moving the unconsumed contents to the start of the buffer.
+ * This compaction is done only when the consumed space is at least STRBUF_STREAM_COMPACT_SIZE and at least the size of the unconsumed contents, or when the space is needed to append, so each character is moved a limited number of times.
+ *
+ * Works with both dynamic and fixed capacity buffers. As with strbuf.h, if an append to a buffer of fixed capacity fails due to insufficient capacity, the buffer will be emptied.
+ *
+ * The buffer holds the consumed characters before the unconsumed ones, so should only be accessed through these functions while the stream is in use.
+ * After strbuf_stream_compact() the buffer holds only the unconsumed contents, and may be used as normal. If it is then modified by other functions, the strbuf_stream_t must be initialized again before further use.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_t* buf = strbuf_create(0, NULL);
+ * strbuf_stream_t stream;
+ *
+ * strbuf_stream_init(&stream, &buf);
+ * strbuf_stream_append(&stream, cstr("GET / HTTP/1.1\r\n"));
+ * strbuf_stream_consume(&stream, 4);
+ * printf("%s\n", strbuf_stream_view(&stream).data);	// "/ HTTP/1.1\r\n"
+ *
+ * strbuf_stream_write(socket_fd, &stream);	// consumes as much as was written
+ *
+ * strbuf_destroy(&buf);
+ * @endcode
+ *
+ * ## Build options
+ * -DSTRBUF_STREAM_COMPACT_SIZE=[size]
+ * The minimum consumed space which is reclaimed when consuming. Defaults to 4096.
+ *
+ */
+
+#ifndef _STRBUF_STREAM_H_
+	#define _STRBUF_STREAM_H_
+
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#ifndef STRBUF_STREAM_COMPACT_SIZE
+		#define STRBUF_STREAM_COMPACT_SIZE	4096
+	#endif
+
+/**
+ * @struct strbuf_stream_t
+ * @brief The state of a stream. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strbuf_stream_t
+	{
+		strbuf_t** buf_ptr;		///< The address of the pointer to the buffer, which is updated if the buffer moves.
+		int head;				///< The number of consumed characters at the start of the buffer.
+	} strbuf_stream_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Begin using a buffer as a stream, with all of it's contents unconsumed.
+ * @param stream The stream state to initialize.
+ * @param buf_ptr The address of a pointer to the buffer, which must remain valid while the stream is in use.
+ **********************************************************************************/
+	void strbuf_stream_init(strbuf_stream_t* stream, strbuf_t** buf_ptr);
+
+/**
+ * @brief Get a view of the unconsumed contents.
+ * @param stream The stream.
+ * @return A view of the unconsumed contents, which is also null terminated.
+ * @note The view is invalidated by any function which appends to or consumes from the stream.
+ **********************************************************************************/
+	strview_t strbuf_stream_view(strbuf_stream_t* stream);
+
+/**
+ * @brief Consume characters from the front of the stream.
+ * @param stream The stream.
+ * @param count The number of characters to consume.
+ * @return The number of characters consumed, which is limited to the size of the unconsumed contents.
+ **********************************************************************************/
+	int strbuf_stream_consume(strbuf_stream_t* stream, int count);
+
+/**
+ * @brief Append to the end of the stream.
+ * @param stream The stream.
+ * @param str The text to append, which may be of the unconsumed contents.
+ * @return A view of the unconsumed contents. If the buffer has a fixed capacity which is insufficient, it will be emptied.
+ * @note Consumed space is reclaimed first if the buffer would otherwise need to grow, and the consumed space is at least the size of the unconsumed contents, or the buffer is of fixed capacity.
+ **********************************************************************************/
+	strview_t strbuf_stream_append(strbuf_stream_t* stream, strview_t str);
+
+/**
+ * @brief Reclaim all consumed space, by moving the unconsumed contents to the start of the buffer.
+ * @param stream The stream.
+ * @return A view of the buffer contents, which are now only the unconsumed contents.
+ **********************************************************************************/
+	strview_t strbuf_stream_compact(strbuf_stream_t* stream);
+
+/**
+ * @brief Append to the stream, attempting to fill the remaining capacity using a POSIX read().
+ * @param stream The stream.
+ * @param fd The file descriptor to read from.
+ * @return The number of bytes appended. 0 for file EOF or buffer full on entry, or -1 for error with errno set.
+ * @note Consumed space is reclaimed first if there is no remaining capacity, or by the same rule as strbuf_stream_consume(), so the unconsumed contents are not moved for every read.
+ * @note Does not increase the buffers capacity. Use strbuf_grow() to suitably size the buffer first.
+ **********************************************************************************/
+	int strbuf_stream_read(strbuf_stream_t* stream, int fd);
+
+/**
+ * @brief Attempt to write the unconsumed contents using a POSIX write(), and consume the number of bytes written.
+ * @param fd The file descriptor to write to.
+ * @param stream The stream.
+ * @return The number of bytes written, or -1 for error with errno set.
+ * @note The return value is that returned by write(), write() will always be called even if the stream is empty.
+ **********************************************************************************/
+	int strbuf_stream_write(int fd, strbuf_stream_t* stream);
+
+#endif
@@ -0,0 +1,444 @@
+/*
+*/
+	#define _GNU_SOURCE
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include <string.h>
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <linux/io_uring.h>
+	#include "strbuf_uring.h"
+	#include "strbuf_io.h"
+	#include "strview_io.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Provided by strbuf.c
+	extern strbuf_allocator_t strbuf_default_allocator;
+
+//	The largest submission queue io_uring supports
+	#define MAX_ENTRIES	32768
+
+	#define NO_OP	(-1)
+
+	typedef enum op_type_t
+	{
+		OP_READ,
+		OP_WRITE
+	} op_type_t;
+
+	typedef struct op_t
+	{
+		op_type_t type;
+		strbuf_t** buf_ptr;					// the buffer being read into
+		strbuf_uring_callback_t callback;
+		void* app_data;
+		int result;							// the result of an operation which was performed when queued
+		int error;							// and it's errno, if the result is -1
+		int next;							// the next op in the free list, or the list of performed ops
+	} op_t;
+
+	struct strbuf_uring_t
+	{
+		strbuf_allocator_t allocator;
+		int entries;
+		int ring_fd;						// -1 if io_uring is not available
+
+		// the submission queue
+		unsigned* sq_tail;
+		unsigned* sq_mask;
+		unsigned* sq_array;
+		struct io_uring_sqe* sqes;
+		int to_submit;
+		int in_flight;						// ops given to io_uring which have not completed, including those not yet submitted
+
+		// the completion queue
+		unsigned* cq_head;
+		unsigned* cq_tail;
+		unsigned* cq_mask;
+		struct io_uring_cqe* cqes;
+
+		// the shared memory
+		void* sq_map;
+		void* cq_map;
+		size_t sq_map_size;
+		size_t cq_map_size;
+		size_t sqes_size;
+
+		int free_op;
+		int performed_first;				// ops performed when queued, waiting for strbuf_uring_poll()
+		int performed_last;
+
+		op_t ops[];
+	};
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static void setup_ring(strbuf_uring_t* uring);
+	static bool supports_read_write(int fd);
+	static void unmap_ring(strbuf_uring_t* uring);
+	static void* map_ring(int fd, size_t size, off_t offset);
+	static int alloc_op(strbuf_uring_t* uring, op_type_t type, strbuf_uring_callback_t callback, void* app_data);
+	static void free_op(strbuf_uring_t* uring, int index);
+	static void queue_sqe(strbuf_uring_t* uring, int index, int fd, void* data, int size);
+	static void queue_performed(strbuf_uring_t* uring, int index, int result);
+	static int poll_ring(strbuf_uring_t* uring, bool wait);
+	static int poll_performed(strbuf_uring_t* uring);
+	static void complete_op(strbuf_uring_t* uring, int index, int result);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+strbuf_uring_t* strbuf_uring_create(int entries, strbuf_allocator_t* allocator)
+{
+	strbuf_uring_t* uring;
+	int i;
+
+	if(!allocator)
+		allocator = &strbuf_default_allocator;
+
+	if(entries < 1)
+		entries = 1;
+	if(entries > MAX_ENTRIES)
+		entries = MAX_ENTRIES;
+
+	uring = allocator->allocator(allocator, NULL, sizeof(strbuf_uring_t) + entries * sizeof(op_t));
+	if(uring)
+	{
+		memset(uring, 0, sizeof(strbuf_uring_t));
+		uring->allocator = *allocator;
+		uring->entries = entries;
+		uring->ring_fd = -1;
+		uring->performed_first = NO_OP;
+		uring->performed_last = NO_OP;
+
+		for(i = 0; i != entries; i++)
+			uring->ops[i].next = i + 1 < entries ? i + 1 : NO_OP;
+		uring->free_op = 0;
+
+		setup_ring(uring);
+	};
+
+	return uring;
+}
+
+void strbuf_uring_destroy(strbuf_uring_t** uring_ptr)
+{
+	strbuf_uring_t* uring;
+	if(uring_ptr && *uring_ptr)
+	{
+		uring = *uring_ptr;
+		if(uring->ring_fd != -1)
+		{
+			unmap_ring(uring);
+			close(uring->ring_fd);
+		};
+		uring->allocator.allocator(&uring->allocator, uring, 0);
+		*uring_ptr = NULL;
+	};
+}
+
+bool strbuf_uring_is_async(strbuf_uring_t* uring)
+{
+	return uring->ring_fd != -1;
+}
+
+bool strbuf_uring_read(strbuf_uring_t* uring, int fd, strbuf_t** buf_ptr, strbuf_uring_callback_t callback, void* app_data)
+{
+	int index = alloc_op(uring, OP_READ, callback, app_data);
+	strbuf_t* buf;
+
+	if(index != NO_OP)
+	{
+		uring->ops[index].buf_ptr = buf_ptr;
+		if(strbuf_uring_is_async(uring))
+		{
+			buf = *buf_ptr;
+			queue_sqe(uring, index, fd, &buf->cstr[buf->size], buf->capacity - buf->size);
+		}
+		else
+			queue_performed(uring, index, strbuf_append_read(buf_ptr, fd));
+	};
+
+	return index != NO_OP;
+}
+
+bool strbuf_uring_write(strbuf_uring_t* uring, int fd, strview_t str, strbuf_uring_callback_t callback, void* app_data)
+{
+	int index = strview_is_valid(str) ? alloc_op(uring, OP_WRITE, callback, app_data) : NO_OP;
+
+	if(index != NO_OP)
+	{
+		if(strbuf_uring_is_async(uring))
+			queue_sqe(uring, index, fd, (void*)str.data, str.size);
+		else
+			queue_performed(uring, index, strview_write(fd, &str));
+	};
+
+	return index != NO_OP;
+}
+
+int strbuf_uring_submit(strbuf_uring_t* uring)
+{
+	int retval = 0;
+
+	if(strbuf_uring_is_async(uring) && uring->to_submit)
+	{
+		retval = syscall(__NR_io_uring_enter, uring->ring_fd, uring->to_submit, 0, 0, NULL, 0);
+		if(retval > 0)
+			uring->to_submit -= retval;
+	};
+
+	return retval;
+}
+
+int strbuf_uring_poll(strbuf_uring_t* uring, bool wait)
+{
+	return strbuf_uring_is_async(uring) ? poll_ring(uring, wait) : poll_performed(uring);
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	Create the io_uring and map it's queues. If any step fails, the ring_fd remains -1 and operations are performed when queued.
+//	Reading and writing at the files current position needs Linux 5.6, earlier kernels with io_uring also fall back.
+static void setup_ring(strbuf_uring_t* uring)
+{
+	struct io_uring_params params;
+	bool single_mmap;
+	int fd;
+	bool failed;
+
+	memset(&params, 0, sizeof(params));
+	fd = syscall(__NR_io_uring_setup, uring->entries, &params);
+	failed = fd < 0 || !(params.features & IORING_FEAT_RW_CUR_POS) || !supports_read_write(fd);
+
+	if(!failed)
+	{
+		uring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		uring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+		// since Linux 5.4 both queues are in one mapping
+		single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+		if(single_mmap && uring->cq_map_size > uring->sq_map_size)
+			uring->sq_map_size = uring->cq_map_size;
+
+		uring->sq_map = map_ring(fd, uring->sq_map_size, IORING_OFF_SQ_RING);
+		uring->cq_map = single_mmap ? uring->sq_map : map_ring(fd, uring->cq_map_size, IORING_OFF_CQ_RING);
+		uring->sqes = map_ring(fd, uring->sqes_size, IORING_OFF_SQES);
+		failed = !uring->sq_map || !uring->cq_map || !uring->sqes;
+	};
+
+	if(!failed)
+	{
+		uring->sq_tail = (unsigned*)((char*)uring->sq_map + params.sq_off.tail);
+		uring->sq_mask = (unsigned*)((char*)uring->sq_map + params.sq_off.ring_mask);
+		uring->sq_array = (unsigned*)((char*)uring->sq_map + params.sq_off.array);
+		uring->cq_head = (unsigned*)((char*)uring->cq_map + params.cq_off.head);
+		uring->cq_tail = (unsigned*)((char*)uring->cq_map + params.cq_off.tail);
+		uring->cq_mask = (unsigned*)((char*)uring->cq_map + params.cq_off.ring_mask);
+		uring->cqes = (struct io_uring_cqe*)((char*)uring->cq_map + params.cq_off.cqes);
+		uring->ring_fd = fd;
+	}
+	else if(fd >= 0)
+	{
+		unmap_ring(uring);
+		close(fd);
+	};
+}
+
+//	Check that IORING_OP_READ and IORING_OP_WRITE are supported. The kernel leaves the flags of opcodes it doesn't know as zero.
+static bool supports_read_write(int fd)
+{
+	char space[sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op)] __attribute__ ((aligned));
+	struct io_uring_probe* probe = (struct io_uring_probe*)space;
+	bool supported;
+
+	memset(space, 0, sizeof(space));
+	supported = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) >= 0;
+	supported = supported && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+	supported = supported && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+
+	return supported;
+}
+
+static void unmap_ring(strbuf_uring_t* uring)
+{
+	if(uring->sqes)
+		munmap(uring->sqes, uring->sqes_size);
+	if(uring->cq_map && uring->cq_map != uring->sq_map)
+		munmap(uring->cq_map, uring->cq_map_size);
+	if(uring->sq_map)
+		munmap(uring->sq_map, uring->sq_map_size);
+	uring->sqes = NULL;
+	uring->cq_map = NULL;
+	uring->sq_map = NULL;
+}
+
+static void* map_ring(int fd, size_t size, off_t offset)
+{
+	void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+//	Take an op from the free list, or return NO_OP if all are in progress
+static int alloc_op(strbuf_uring_t* uring, op_type_t type, strbuf_uring_callback_t callback, void* app_data)
+{
+	int index = uring->free_op;
+	op_t* op;
+
+	if(index != NO_OP)
+	{
+		op = &uring->ops[index];
+		uring->free_op = op->next;
+		op->type = type;
+		op->buf_ptr = NULL;
+		op->callback = callback;
+		op->app_data = app_data;
+		op->next = NO_OP;
+	};
+
+	return index;
+}
+
+static void free_op(strbuf_uring_t* uring, int index)
+{
+	uring->ops[index].next = uring->free_op;
+	uring->free_op = index;
+}
+
+//	Add a read or write to the submission queue. As no more ops than entries are in progress, the queue can't be full.
+//	An offset of -1 reads or writes at the files current position, as read() and write() do.
+static void queue_sqe(strbuf_uring_t* uring, int index, int fd, void* data, int size)
+{
+	unsigned tail = *uring->sq_tail;
+	unsigned slot = tail & *uring->sq_mask;
+	struct io_uring_sqe* sqe = &uring->sqes[slot];
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = uring->ops[index].type == OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)data;
+	sqe->len = size;
+	sqe->off = (uint64_t)-1;
+	sqe->user_data = index;
+
+	uring->sq_array[slot] = slot;
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	uring->to_submit++;
+	uring->in_flight++;
+}
+
+//	Hold the result of an op which was performed when queued, until strbuf_uring_poll()
+static void queue_performed(strbuf_uring_t* uring, int index, int result)
+{
+	uring->ops[index].result = result;
+	uring->ops[index].error = result < 0 ? errno : 0;
+	if(uring->performed_last != NO_OP)
+		uring->ops[uring->performed_last].next = index;
+	else
+		uring->performed_first = index;
+	uring->performed_last = index;
+}
+
+static int poll_ring(strbuf_uring_t* uring, bool wait)
+{
+	unsigned head = *uring->cq_head;
+	unsigned tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+	unsigned flags = 0;
+	unsigned min_complete = 0;
+	struct io_uring_cqe cqe;
+	int retval = 0;
+	int count = 0;
+
+	// with nothing in flight, no completion could end the wait
+	if(wait && head == tail && uring->in_flight)
+	{
+		flags = IORING_ENTER_GETEVENTS;
+		min_complete = 1;
+	};
+
+	if(uring->to_submit || min_complete)
+	{
+		retval = syscall(__NR_io_uring_enter, uring->ring_fd, uring->to_submit, min_complete, flags, NULL, 0);
+		if(retval >= 0)
+			uring->to_submit -= retval;
+		tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+	};
+
+	// completions which arrive while callbacks run are left for the next poll
+	// each is copied before the head is advanced, as the kernel may then reuse it's entry
+	while(retval >= 0 && head != tail)
+	{
+		cqe = uring->cqes[head & *uring->cq_mask];
+		head++;
+		__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+		uring->in_flight--;
+		complete_op(uring, cqe.user_data, cqe.res);
+		count++;
+	};
+
+	return retval < 0 ? -1 : count;
+}
+
+static int poll_performed(strbuf_uring_t* uring)
+{
+	int index = uring->performed_first;
+	int next;
+	int count = 0;
+
+	// ops queued by the callbacks are left for the next poll
+	uring->performed_first = NO_OP;
+	uring->performed_last = NO_OP;
+
+	while(index != NO_OP)
+	{
+		next = uring->ops[index].next;
+		complete_op(uring, index, uring->ops[index].result);
+		index = next;
+		count++;
+	};
+
+	return count;
+}
+
+//	Apply the result of an op, and free it before calling it's callback so the callback may queue another
+//	A negative result from io_uring is -errno, an op performed when queued has it's errno saved with the result
+static void complete_op(strbuf_uring_t* uring, int index, int result)
+{
+	op_t op = uring->ops[index];
+	strbuf_t* buf;
+	int saved_errno = errno;
+
+	if(strbuf_uring_is_async(uring) && result < 0)
+	{
+		saved_errno = -result;
+		result = -1;
+	}
+	else if(result < 0)
+		saved_errno = op.error;
+	else if(strbuf_uring_is_async(uring) && op.type == OP_READ && result > 0)
+	{
+		buf = *op.buf_ptr;
+		buf->size += result;
+		buf->cstr[buf->size] = 0;
+	};
+
+	free_op(uring, index);
+
+	if(op.callback)
+	{
+		errno = saved_errno;
+		op.callback(op.app_data, result);
+	};
+}
@@ -0,0 +1,132 @@
+/**
+ * @file strbuf_uring.h
+ * @brief An accessory to strbuf.h for asynchronous reading into buffers, and writing from views, using Linux io_uring.
+ * @author Michael Clift
+ *
+ * Reads and writes on any number of file descriptors are queued, then submitted together with a single system call.
+ * Their completions are collected by strbuf_uring_poll(), which calls the callback given for each operation.
+ *
+ * A read appends to the buffer, filling it's remaining capacity as strbuf_append_read() from strbuf_io.h would.
+ * A write writes a view, as strview_write() from strview_io.h would, but does not modify the view.
+ * The callback is passed the result as read() or write() would return it, so -1 with errno set for an error.
+ *
+ * If io_uring is not available, for example on a kernel before Linux 5.6, or where it is disabled, each operation is instead performed by strbuf_append_read() or strview_write() when it is queued.
+ * It's callback is still only called from strbuf_uring_poll(), so the application works the same either way.
+ *
+ * While a read is in progress, the buffer must not be modified or destroyed. While a write is in progress, the memory it's view refers to must remain valid.
+ * Only one operation at a time should be in progress on each buffer.
+ *
+ * Requires Linux. strbuf_io.c and strview_io.c must also be compiled.
+ *
+ * Example:
+ * @code{.c}
+ * void on_read(void* app_data, int result)
+ * {
+ * 	connection_t* conn = app_data;
+ * 	if(result > 0)
+ * 		handle_input(conn, strbuf_view(&conn->rx_buf));
+ * }
+ *
+ * strbuf_uring_t* uring = strbuf_uring_create(256, NULL);
+ *
+ * for(int i = 0; i < connection_count; i++)
+ * 	strbuf_uring_read(uring, conns[i].fd, &conns[i].rx_buf, on_read, &conns[i]);
+ *
+ * while(running)
+ * 	strbuf_uring_poll(uring, true);		// submits the reads, and waits for at least one to complete
+ *
+ * strbuf_uring_destroy(&uring);
+ * @endcode
+ *
+ */
+
+#ifndef _STRBUF_URING_H_
+	#define _STRBUF_URING_H_
+
+	#include <stdbool.h>
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strbuf_uring_t
+ * @brief A queue of asynchronous operations. The contents are private.
+ **********************************************************************************/
+	typedef struct strbuf_uring_t strbuf_uring_t;
+
+/**
+ * @brief The function called when an operation completes.
+ * @param app_data The app_data pointer given when the operation was queued.
+ * @param result The number of bytes read or written, 0 for end of file, or -1 with errno set for an error.
+ **********************************************************************************/
+	typedef void (*strbuf_uring_callback_t)(void* app_data, int result);
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Create a queue for asynchronous operations.
+ * @param entries The maximum number of operations which may be in progress at once.
+ * @param allocator A pointer to a strbuf_allocator_t which provides the allocator to use, or NULL to use the default allocator.
+ * @return The queue, or NULL if memory could not be allocated. If io_uring is not available the queue is still created, see strbuf_uring_is_async().
+ **********************************************************************************/
+	strbuf_uring_t* strbuf_uring_create(int entries, strbuf_allocator_t* allocator);
+
+/**
+ * @brief Destroy a queue.
+ * @param uring_ptr The address of a pointer to the queue, which will be set to NULL.
+ * @note Operations still in progress are abandoned, their callbacks are not called, and their buffers must not be used until the file descriptors have been closed.
+ **********************************************************************************/
+	void strbuf_uring_destroy(strbuf_uring_t** uring_ptr);
+
+/**
+ * @brief Determine if a queue is using io_uring.
+ * @param uring The queue.
+ * @return True if operations are performed asynchronously by io_uring, false if they are performed when queued.
+ **********************************************************************************/
+	bool strbuf_uring_is_async(strbuf_uring_t* uring);
+
+/**
+ * @brief Queue a read, which will append to a buffer.
+ * @param uring The queue.
+ * @param fd The file descriptor to read from.
+ * @param buf_ptr The address of a pointer to the buffer, which must remain valid until the operation completes.
+ * @param callback The function to call when the read completes, or NULL.
+ * @param app_data A pointer passed to the callback.
+ * @return True if queued, false if the maximum number of operations are already in progress.
+ * @note As with strbuf_append_read(), the capacity of the buffer is not increased. Use strbuf_grow() to suitably size the buffer first.
+ **********************************************************************************/
+	bool strbuf_uring_read(strbuf_uring_t* uring, int fd, strbuf_t** buf_ptr, strbuf_uring_callback_t callback, void* app_data);
+
+/**
+ * @brief Queue a write of a view.
+ * @param uring The queue.
+ * @param fd The file descriptor to write to.
+ * @param str The data to write, which must remain valid until the operation completes.
+ * @param callback The function to call when the write completes, or NULL.
+ * @param app_data A pointer passed to the callback.
+ * @return True if queued, false if the maximum number of operations are already in progress, or str is invalid.
+ **********************************************************************************/
+	bool strbuf_uring_write(strbuf_uring_t* uring, int fd, strview_t str, strbuf_uring_callback_t callback, void* app_data);
+
+/**
+ * @brief Submit all queued operations with a single system call.
+ * @param uring The queue.
+ * @return The number of operations submitted, or -1 with errno set for an error.
+ * @note strbuf_uring_poll() also submits any queued operations, so this is only needed to start them sooner.
+ **********************************************************************************/
+	int strbuf_uring_submit(strbuf_uring_t* uring);
+
+/**
+ * @brief Submit any queued operations, and call the callbacks of those which have completed.
+ * @param uring The queue.
+ * @param wait If true, and no operations have completed, wait for at least one to complete. There is no wait if no operations are in progress.
+ * @return The number of operations completed, or -1 with errno set for an error.
+ * @note Callbacks may queue further operations.
+ **********************************************************************************/
+	int strbuf_uring_poll(strbuf_uring_t* uring, bool wait);
+
+#endif
@@ -0,0 +1,128 @@
+/*
+*/
+	#define _GNU_SOURCE
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/stat.h>
+	#include <sys/sendfile.h>
+	#include "strfile.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Linux transfers at most this many bytes per call, which also keeps the result representable as an int
+	#define MAX_TRANSFER	0x7FFFF000
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static size_t transfer_size(strfile_t* src);
+	static void consume(strfile_t* src, ssize_t count);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+strfile_t strfile_of_fd(int fd)
+{
+	strfile_t file = STRFILE_INVALID;
+	struct stat st;
+
+	if(fstat(fd, &st) == 0)
+	{
+		file.fd = fd;
+		file.size = st.st_size;
+	};
+
+	return file;
+}
+
+bool strfile_is_valid(strfile_t file)
+{
+	return file.fd >= 0;
+}
+
+strfile_t strfile_sub(strfile_t file, off_t begin, off_t end)
+{
+	if(end > file.size)
+		end = file.size;
+	if(begin > end)
+		begin = end;
+	if(begin < 0)
+		begin = 0;
+	if(end < begin)
+		end = begin;
+
+	file.offset += begin;
+	file.size = end - begin;
+	return file;
+}
+
+int strfile_send(int fd, strfile_t* src)
+{
+	ssize_t retval = 0;
+	off_t offset;
+
+	if(src && strfile_is_valid(*src))
+	{
+		offset = src->offset;
+		retval = sendfile(fd, src->fd, &offset, transfer_size(src));
+		consume(src, retval);
+	};
+
+	return retval;
+}
+
+int strfile_copy(int fd, strfile_t* src)
+{
+	ssize_t retval = 0;
+	off_t offset;
+
+	if(src && strfile_is_valid(*src))
+	{
+		offset = src->offset;
+		retval = copy_file_range(src->fd, &offset, fd, NULL, transfer_size(src), 0);
+		if(retval == -1 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL))
+			retval = strfile_send(fd, src);
+		else
+			consume(src, retval);
+	};
+
+	return retval;
+}
+
+int strfile_splice(int pipe_fd, strfile_t* src)
+{
+	ssize_t retval = 0;
+	loff_t offset;
+
+	if(src && strfile_is_valid(*src))
+	{
+		offset = src->offset;
+		retval = splice(src->fd, &offset, pipe_fd, NULL, transfer_size(src), SPLICE_F_MOVE);
+		consume(src, retval);
+	};
+
+	return retval;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static size_t transfer_size(strfile_t* src)
+{
+	return src->size > MAX_TRANSFER ? MAX_TRANSFER : (size_t)src->size;
+}
+
+static void consume(strfile_t* src, ssize_t count)
+{
+	if(count > 0)
+	{
+		src->offset += count;
+		src->size -= count;
+	};
+}
@@ -0,0 +1,106 @@
+/**
+ * @file strfile.h
+ * @brief An accessory for transferring regions of open files without copying them through user space.
+ * @author Michael Clift
+ *
+ * A strfile_t is to a file what a strview_t is to memory, an offset and a size within an open file descriptor.
+ * Transfers use sendfile(), copy_file_range() or splice(), so the data is moved by the kernel, and never read into a buffer.
+ * Each transfer function follows the conventions of strview_write() from strview_io.h, it returns the number of bytes transferred, or -1 with errno set,
+ * and removes the bytes transferred from the front of the view. A partial transfer can therefore be continued by calling the function again with the same view.
+ *
+ * The views offset is used instead of the files position, which is not changed. The file descriptor is not owned by the view, and is not closed.
+ *
+ * Requires Linux.
+ *
+ * Example:
+ * @code{.c}
+ * int fd = open("index.html", O_RDONLY);
+ * strfile_t file = strfile_of_fd(fd);
+ *
+ * while(strfile_is_valid(file) && file.size && strfile_send(socket_fd, &file) > 0)
+ * 	;
+ *
+ * close(fd);
+ * @endcode
+ *
+ */
+
+#ifndef _STRFILE_H_
+	#define _STRFILE_H_
+
+	#include <stdbool.h>
+	#include <sys/types.h>
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strfile_t
+ * @brief A view of a region of an open file.
+ **********************************************************************************/
+	typedef struct strfile_t
+	{
+		int fd;				///< The file descriptor, or -1 for an invalid view.
+		off_t offset;		///< The offset of the region within the file.
+		off_t size;			///< The size of the region.
+	} strfile_t;
+
+	#define STRFILE_INVALID	((strfile_t){.fd = -1, .offset = 0, .size = 0})
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Get a view of an entire file.
+ * @param fd The file descriptor of a regular file.
+ * @return A view from offset 0 to the current size of the file, or STRFILE_INVALID if the size could not be found, with errno set.
+ **********************************************************************************/
+	strfile_t strfile_of_fd(int fd);
+
+/**
+ * @brief Determine if a view is valid.
+ * @param file The view.
+ * @return True if the view refers to a file descriptor.
+ **********************************************************************************/
+	bool strfile_is_valid(strfile_t file);
+
+/**
+ * @brief Get a view of a region within another view.
+ * @param file The view.
+ * @param begin The offset of the region, relative to the start of the view.
+ * @param end The end of the region, relative to the start of the view.
+ * @return A view of the region. As with strview_sub(), begin and end are limited to the size of the view, and end to no less than begin.
+ **********************************************************************************/
+	strfile_t strfile_sub(strfile_t file, off_t begin, off_t end);
+
+/**
+ * @brief Attempt to send the region to another file descriptor using sendfile(), and remove the number of bytes sent from the view.
+ * @param fd The file descriptor to send to, which may be a socket, pipe or file.
+ * @param src The address of the view.
+ * @return The number of bytes sent, 0 if the end of the file was reached, or -1 for error with errno set.
+ * @note sendfile() will be called even if the view is empty, but NOT if it is invalid.
+ **********************************************************************************/
+	int strfile_send(int fd, strfile_t* src);
+
+/**
+ * @brief Attempt to copy the region to another file using copy_file_range(), and remove the number of bytes copied from the view.
+ * @param fd The file descriptor of a regular file to copy to, which is written at it's current position.
+ * @param src The address of the view.
+ * @return The number of bytes copied, 0 if the end of the file was reached, or -1 for error with errno set.
+ * @note copy_file_range() may share the data blocks between the files, or copy them on the storage device, where supported.
+ * @note If copy_file_range() is not supported between the files, for example they are on different filesystems before Linux 5.3, then strfile_send() is used.
+ **********************************************************************************/
+	int strfile_copy(int fd, strfile_t* src);
+
+/**
+ * @brief Attempt to move the region into a pipe using splice(), and remove the number of bytes moved from the view.
+ * @param pipe_fd The file descriptor of the write end of a pipe.
+ * @param src The address of the view.
+ * @return The number of bytes moved, 0 if the end of the file was reached, or -1 for error with errno set.
+ * @note This is limited by the free space in the pipe. The data may then be spliced from the pipe to a socket or file.
+ **********************************************************************************/
+	int strfile_splice(int pipe_fd, strfile_t* src);
+
+#endif
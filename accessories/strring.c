@@ -0,0 +1,163 @@
+/*
+*/
+	#define _GNU_SOURCE
+	#include <limits.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include "strring.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static char* map_mirrored(int fd, size_t size);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+bool strring_init(strring_t* ring, int min_capacity)
+{
+	long page_size = sysconf(_SC_PAGESIZE);
+	long capacity = min_capacity < 1 ? 1 : min_capacity;
+	int fd = -1;
+	bool failed;
+
+	*ring = (strring_t){0};
+
+	capacity = (capacity + page_size - 1) / page_size * page_size;
+	failed = capacity > INT_MAX / 2;	// keep positions within both mappings representable
+
+	if(!failed)
+	{
+		fd = memfd_create("strring", MFD_CLOEXEC);
+		failed = fd == -1;
+	};
+
+	if(!failed)
+		failed = ftruncate(fd, capacity) == -1;
+
+	if(!failed)
+	{
+		ring->data = map_mirrored(fd, capacity);
+		failed = !ring->data;
+	};
+
+	if(fd != -1)
+		close(fd);	// the mappings keep the memory
+
+	if(!failed)
+		ring->capacity = capacity;
+
+	return !failed;
+}
+
+void strring_destroy(strring_t* ring)
+{
+	if(ring->data)
+		munmap(ring->data, (size_t)ring->capacity * 2);
+	*ring = (strring_t){0};
+}
+
+strview_t strring_view(strring_t* ring)
+{
+	return (strview_t){.data = &ring->data[ring->head], .size = ring->size};
+}
+
+int strring_consume(strring_t* ring, int count)
+{
+	if(count > ring->size)
+		count = ring->size;
+	if(count < 0)
+		count = 0;
+
+	ring->size -= count;
+	ring->head += count;
+	if(ring->head >= ring->capacity)
+		ring->head -= ring->capacity;
+
+	return count;
+}
+
+strview_t strring_append(strring_t* ring, strview_t str)
+{
+	char* space = strview_is_valid(str) ? strring_reserve(ring, str.size) : NULL;
+
+	if(space)
+	{
+		// str may be of the contents, which the space never overlaps in the first mapping or it's mirror
+		memcpy(space, str.data, str.size);
+		strring_commit(ring, str.size);
+	}
+	else
+	{
+		ring->head = 0;
+		ring->size = 0;
+	};
+
+	return strring_view(ring);
+}
+
+char* strring_reserve(strring_t* ring, int size)
+{
+	char* space = NULL;
+	if(size >= 0 && size <= ring->capacity - ring->size)
+		space = &ring->data[ring->head + ring->size];
+	return space;
+}
+
+strview_t strring_commit(strring_t* ring, int size)
+{
+	if(size > ring->capacity - ring->size)
+		size = ring->capacity - ring->size;
+	if(size > 0)
+		ring->size += size;
+	return strring_view(ring);
+}
+
+int strring_read(strring_t* ring, int fd)
+{
+	int retval = read(fd, &ring->data[ring->head + ring->size], ring->capacity - ring->size);
+
+	if(retval > 0)
+		ring->size += retval;
+
+	return retval;
+}
+
+int strring_write(int fd, strring_t* ring)
+{
+	int retval = write(fd, &ring->data[ring->head], ring->size);
+
+	if(retval > 0)
+		strring_consume(ring, retval);
+
+	return retval;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	Reserve address space for two copies of the file, and map the file into both halves
+static char* map_mirrored(int fd, size_t size)
+{
+	char* base = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	bool failed = base == MAP_FAILED;
+
+	if(!failed)
+		failed = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED;
+
+	if(!failed)
+		failed = mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED;
+
+	if(failed && base != MAP_FAILED)
+		munmap(base, size * 2);
+
+	return failed ? NULL : base;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file strring.h
+ * @brief A ring buffer for streaming, whose contents are always a single contiguous view.
+ * @author Michael Clift
+ *
+ * The memory of the ring is mapped twice, back to back, so the contents and the free space are each contiguous even when they wrap around the end.
+ * A view of the contents can therefore be passed to any strview.h function, such as strview_split_line() or strview_find_first(), without first copying it into order.
+ * Consuming from the front and appending to the end never move the contents.
+ *
+ * The capacity is fixed when the ring is initialized, and is rounded up to a multiple of the page size.
+ * As with strbuf.h, if an append fails due to insufficient capacity, the ring will be emptied.
+ * Unlike a strbuf_t, the contents are not null terminated.
+ *
+ * Requires Linux, for memfd_create().
+ *
+ * Example:
+ * @code{.c}
+ * strring_t ring;
+ * strview_t contents;
+ * strview_t line;
+ *
+ * if(strring_init(&ring, 65536))
+ * {
+ * 	while(strring_read(&ring, socket_fd) > 0)
+ * 	{
+ * 		contents = strring_view(&ring);
+ * 		line = strview_split_line(&contents, NULL);
+ * 		while(strview_is_valid(line))
+ * 		{
+ * 			handle_line(line);
+ * 			line = strview_split_line(&contents, NULL);
+ * 		};
+ * 		strring_consume(&ring, ring.size - contents.size);	// remove the complete lines
+ * 	};
+ * 	strring_destroy(&ring);
+ * };
+ * @endcode
+ *
+ * A view of the contents may also be written with strview_write() from strview_io.h, followed by strring_consume() with the number of bytes written, which is what strring_write() does.
+ *
+ */
+
+#ifndef _STRRING_H_
+	#define _STRRING_H_
+
+	#include <stdbool.h>
+	#include "strview.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strring_t
+ * @brief A mirrored ring buffer. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strring_t
+	{
+		char* data;			///< The first of the two mappings, the second follows immediately after at data + capacity.
+		int capacity;		///< The size of each mapping.
+		int head;			///< The position of the contents, from 0 to capacity-1.
+		int size;			///< The size of the contents.
+	} strring_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Create the memory for a ring.
+ * @param ring The ring to initialize.
+ * @param min_capacity The minimum capacity, which will be rounded up to a multiple of the page size.
+ * @return True if successful. False if the memory could not be created or mapped, in which case the ring is zeroed.
+ **********************************************************************************/
+	bool strring_init(strring_t* ring, int min_capacity);
+
+/**
+ * @brief Free the memory of a ring.
+ * @param ring The ring, which will be zeroed.
+ **********************************************************************************/
+	void strring_destroy(strring_t* ring);
+
+/**
+ * @brief Get a view of the contents.
+ * @param ring The ring.
+ * @return A view of the contents, which is contiguous even if the contents wrap around the end of the ring.
+ * @note The view remains valid until the contents are consumed.
+ **********************************************************************************/
+	strview_t strring_view(strring_t* ring);
+
+/**
+ * @brief Consume characters from the front of the ring.
+ * @param ring The ring.
+ * @param count The number of characters to consume.
+ * @return The number of characters consumed, which is limited to the size of the contents.
+ **********************************************************************************/
+	int strring_consume(strring_t* ring, int count);
+
+/**
+ * @brief Append to the end of the ring.
+ * @param ring The ring.
+ * @param str The text to append, which may be of the rings contents.
+ * @return A view of the contents. If there is insufficient free space, the ring will be emptied.
+ **********************************************************************************/
+	strview_t strring_append(strring_t* ring, strview_t str);
+
+/**
+ * @brief Get the free space following the contents, for appending to directly.
+ * @param ring The ring.
+ * @param size The number of characters which will be written.
+ * @return A pointer to the free space, or NULL if size is larger than the free space. The ring is not modified.
+ * @note After writing to the space, use strring_commit() to add it to the contents.
+ **********************************************************************************/
+	char* strring_reserve(strring_t* ring, int size);
+
+/**
+ * @brief Add characters written to the space from strring_reserve() to the contents.
+ * @param ring The ring.
+ * @param size The number of characters written, which is limited to the free space.
+ * @return A view of the contents.
+ **********************************************************************************/
+	strview_t strring_commit(strring_t* ring, int size);
+
+/**
+ * @brief Append to the ring, attempting to fill the free space using a POSIX read().
+ * @param ring The ring.
+ * @param fd The file descriptor to read from.
+ * @return The number of bytes appended. 0 for file EOF or ring full on entry, or -1 for error with errno set.
+ * @note The free space is always contiguous, so a single read() can fill it.
+ **********************************************************************************/
+	int strring_read(strring_t* ring, int fd);
+
+/**
+ * @brief Attempt to write the contents of the ring using a POSIX write(), and consume the number of bytes written.
+ * @param fd The file descriptor to write to.
+ * @param ring The ring.
+ * @return The number of bytes written, or -1 for error with errno set.
+ * @note The return value is that returned by write(), write() will always be called even if the ring is empty.
+ **********************************************************************************/
+	int strring_write(int fd, strring_t* ring);
+
+#endif
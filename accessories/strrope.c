@@ -0,0 +1,677 @@
+/*
+*/
+	#include <limits.h>
+	#include <string.h>
+	#include "strrope.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	Provided by strbuf.c
+	extern strbuf_allocator_t strbuf_default_allocator;
+
+//	Chunks are allocated to fit their contents, rounded up to a multiple of this
+	#define CAPACITY_STEP	64
+
+//	Neighbouring chunks are joined when one holds less than this, and both fit in one chunk
+	#define MIN_FILL		(STRROPE_CHUNK_SIZE / 2)
+
+//	A chunk of the rope. It's position is the size of everything to it's left, in order.
+//	Priorities are a max-heap, which keeps the tree balanced with high probability.
+	typedef struct strrope_node_t
+	{
+		struct strrope_node_t* left;
+		struct strrope_node_t* right;
+		uint32_t priority;
+		int size;		// of this subtree
+		int length;		// of this chunk
+		int capacity;	// of this chunk
+		char data[];
+	} node_t;
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static node_t* new_node(strrope_t* rope, strview_t str, int capacity);
+	static node_t* resize_node(strrope_t* rope, node_t* node, int capacity);
+	static int round_capacity(int capacity);
+	static void free_tree(strrope_t* rope, node_t* node);
+	static node_t* build_tree(strrope_t* rope, strview_t str);
+	static node_t* find_chunk(node_t* node, int index, int* start);
+	static int tail_length(node_t* node, int index);
+	static node_t* insert_in_place(strrope_t* rope, node_t* node, int index, strview_t str, bool* inserted);
+	static void delete_in_place(node_t* node, int index, int count);
+	static void coalesce(strrope_t* rope, int index);
+	static bool join_chunks(strrope_t* rope, node_t** first, node_t** second);
+	static node_t* pop_first(node_t** tree);
+	static node_t* pop_last(node_t** tree);
+	static void split(node_t* node, int index, node_t** left, node_t** right, node_t** spare);
+	static node_t* merge(node_t* left, node_t* right);
+	static void update(node_t* node);
+	static int size_of(node_t* node);
+	static void append_tree_to_buf(node_t* node, strbuf_t** buf_ptr);
+	static uint32_t next_priority(strrope_t* rope);
+	static int clamp_index(strrope_t* rope, int index);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+void strrope_init(strrope_t* rope, strbuf_allocator_t* allocator)
+{
+	if(!allocator)
+		allocator = &strbuf_default_allocator;
+
+	rope->allocator = *allocator;
+	rope->root = NULL;
+	rope->seed = 0x9E3779B9;
+}
+
+void strrope_destroy(strrope_t* rope)
+{
+	free_tree(rope, rope->root);
+	rope->root = NULL;
+}
+
+int strrope_size(strrope_t* rope)
+{
+	return size_of(rope->root);
+}
+
+bool strrope_insert(strrope_t* rope, int index, strview_t str)
+{
+	node_t* left;
+	node_t* right;
+	node_t* middle = NULL;
+	node_t* spare = NULL;
+	int spare_length;
+	bool inserted = false;
+	bool failed = !strview_is_valid(str) || str.size > INT_MAX - strrope_size(rope);
+
+	index = clamp_index(rope, index);
+
+	// small inserts go into the free space of an existing chunk
+	if(!failed && str.size)
+		rope->root = insert_in_place(rope, rope->root, index, str, &inserted);
+
+	if(!failed && str.size && !inserted)
+	{
+		middle = build_tree(rope, str);
+		spare_length = tail_length(rope->root, index);
+		if(spare_length)
+			spare = new_node(rope, STRVIEW_INVALID, spare_length);
+		failed = !middle || (spare_length && !spare);
+
+		if(!failed)
+		{
+			split(rope->root, index, &left, &right, &spare);
+			rope->root = merge(merge(left, middle), right);
+			coalesce(rope, index);
+			coalesce(rope, index + str.size);
+		}
+		else
+			free_tree(rope, middle);
+
+		free_tree(rope, spare);
+	};
+
+	return !failed;
+}
+
+bool strrope_delete(strrope_t* rope, int index, int size)
+{
+	node_t* left;
+	node_t* middle;
+	node_t* right;
+	node_t* chunk;
+	int start;
+	int count;
+
+	index = clamp_index(rope, index);
+	if(size > strrope_size(rope) - index)
+		size = strrope_size(rope) - index;
+
+	// the end of the first chunk, and the start of the last, are removed in place
+	if(size > 0)
+	{
+		chunk = find_chunk(rope->root, index, &start);
+		if(index > start)
+		{
+			count = start + chunk->length - index;
+			if(count > size)
+				count = size;
+			delete_in_place(rope->root, index, count);
+			size -= count;
+		};
+	};
+
+	if(size > 0)
+	{
+		chunk = find_chunk(rope->root, index + size - 1, &start);
+		if(index + size < start + chunk->length)
+		{
+			count = index + size - start;
+			delete_in_place(rope->root, start, count);
+			size -= count;
+		};
+	};
+
+	// whole chunks remain, which begin and end on chunk boundaries
+	if(size > 0)
+	{
+		split(rope->root, index, &left, &right, NULL);
+		split(right, size, &middle, &right, NULL);
+		free_tree(rope, middle);
+		rope->root = merge(left, right);
+	};
+
+	coalesce(rope, index);
+
+	return true;
+}
+
+bool strrope_split(strrope_t* rope, int index, strrope_t* tail)
+{
+	node_t* spare = NULL;
+	int spare_length;
+	bool failed;
+
+	index = clamp_index(rope, index);
+	spare_length = tail_length(rope->root, index);
+	if(spare_length)
+		spare = new_node(rope, STRVIEW_INVALID, spare_length);
+	failed = spare_length && !spare;
+
+	*tail = *rope;
+	tail->root = NULL;
+
+	if(!failed)
+	{
+		split(rope->root, index, &rope->root, &tail->root, &spare);
+		coalesce(rope, index);
+		coalesce(tail, 0);
+	};
+
+	return !failed;
+}
+
+void strrope_join(strrope_t* rope, strrope_t* tail)
+{
+	int index = strrope_size(rope);
+
+	rope->root = merge(rope->root, tail->root);
+	tail->root = NULL;
+	coalesce(rope, index);
+}
+
+strview_t strrope_chunk(strrope_t* rope, int index)
+{
+	strview_t result = STRVIEW_INVALID;
+	node_t* node = NULL;
+	int start;
+
+	if(index >= 0)
+		node = find_chunk(rope->root, index, &start);
+
+	if(node)
+	{
+		result.data = &node->data[index - start];
+		result.size = node->length - (index - start);
+	};
+
+	return result;
+}
+
+strview_t strrope_to_strbuf(strrope_t* rope, strbuf_t** buf_ptr)
+{
+	strview_t result = STRVIEW_INVALID;
+	int size = strrope_size(rope);
+
+	if(buf_ptr && *buf_ptr)
+	{
+		strbuf_assign(buf_ptr, cstr(""));
+		if((*buf_ptr)->capacity < size)
+			strbuf_grow(buf_ptr, size);
+
+		if((*buf_ptr)->capacity >= size)
+		{
+			append_tree_to_buf(rope->root, buf_ptr);
+			result = strbuf_view(buf_ptr);
+		};
+	};
+
+	return result;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+//	Allocate a chunk holding up to STRROPE_CHUNK_SIZE of str, which may be invalid for an empty chunk, with room for at least capacity.
+static node_t* new_node(strrope_t* rope, strview_t str, int capacity)
+{
+	int length = str.size < STRROPE_CHUNK_SIZE ? str.size : STRROPE_CHUNK_SIZE;
+	node_t* node;
+
+	capacity = round_capacity(length > capacity ? length : capacity);
+	node = rope->allocator.allocator(&rope->allocator, NULL, sizeof(node_t) + capacity);
+
+	if(node)
+	{
+		node->left = NULL;
+		node->right = NULL;
+		node->priority = next_priority(rope);
+		node->length = length;
+		node->size = length;
+		node->capacity = capacity;
+		if(length)
+			memcpy(node->data, str.data, length);
+	};
+
+	return node;
+}
+
+//	Reallocate a chunk which is not linked into a tree, or whose parent will be updated. Returns NULL on failure, leaving the chunk unchanged.
+static node_t* resize_node(strrope_t* rope, node_t* node, int capacity)
+{
+	node_t* result = node;
+
+	capacity = round_capacity(capacity);
+	if(capacity != node->capacity)
+	{
+		result = rope->allocator.allocator(&rope->allocator, node, sizeof(node_t) + capacity);
+		if(result)
+			result->capacity = capacity;
+	};
+
+	return result;
+}
+
+static int round_capacity(int capacity)
+{
+	capacity = (capacity + CAPACITY_STEP - 1) / CAPACITY_STEP * CAPACITY_STEP;
+	if(capacity > STRROPE_CHUNK_SIZE)
+		capacity = STRROPE_CHUNK_SIZE;
+	if(capacity < 1)
+		capacity = CAPACITY_STEP < STRROPE_CHUNK_SIZE ? CAPACITY_STEP : STRROPE_CHUNK_SIZE;
+	return capacity;
+}
+
+static void free_tree(strrope_t* rope, node_t* node)
+{
+	node_t* right;
+
+	while(node)
+	{
+		free_tree(rope, node->left);
+		right = node->right;
+		rope->allocator.allocator(&rope->allocator, node, 0);
+		node = right;
+	};
+}
+
+//	Build a tree of chunks holding str. Returns NULL if any allocation fails.
+static node_t* build_tree(strrope_t* rope, strview_t str)
+{
+	node_t* tree = NULL;
+	node_t* node;
+	bool failed = false;
+
+	while(str.size && !failed)
+	{
+		node = new_node(rope, str, 0);
+		failed = !node;
+		if(!failed)
+		{
+			strview_split_index(&str, node->length);
+			tree = merge(tree, node);
+		};
+	};
+
+	if(failed)
+	{
+		free_tree(rope, tree);
+		tree = NULL;
+	};
+
+	return tree;
+}
+
+//	Return the chunk containing index, and it's position in *start, or NULL if index is outside of the tree.
+static node_t* find_chunk(node_t* node, int index, int* start)
+{
+	node_t* result = NULL;
+	int left_size;
+
+	*start = 0;
+	while(node)
+	{
+		left_size = size_of(node->left);
+		if(index < left_size)
+			node = node->left;
+		else if(index < left_size + node->length)
+		{
+			*start += left_size;
+			result = node;
+			node = NULL;
+		}
+		else
+		{
+			index -= left_size + node->length;
+			*start += left_size + node->length;
+			node = node->right;
+		};
+	};
+
+	return result;
+}
+
+//	Return the size of the part of a chunk which split() would move to a spare at index, or 0 if index is on a chunk boundary.
+static int tail_length(node_t* node, int index)
+{
+	int start;
+	int length = 0;
+
+	node = find_chunk(node, index, &start);
+	if(node && index != start)
+		length = start + node->length - index;
+
+	return length;
+}
+
+//	If the chunk containing or ending at index has room for str, or can grow to hold it, insert it there and set *inserted.
+//	Returns the node, which may have moved.
+static node_t* insert_in_place(strrope_t* rope, node_t* node, int index, strview_t str, bool* inserted)
+{
+	node_t* resized;
+	int left_size;
+
+	if(node)
+	{
+		left_size = size_of(node->left);
+		if(index < left_size)
+			node->left = insert_in_place(rope, node->left, index, str, inserted);
+		else if(index <= left_size + node->length)
+		{
+			index -= left_size;
+			if(node->length + str.size > node->capacity && node->length + str.size <= STRROPE_CHUNK_SIZE)
+			{
+				resized = resize_node(rope, node, node->length + str.size);
+				if(resized)
+					node = resized;
+			};
+
+			*inserted = node->length + str.size <= node->capacity;
+			if(*inserted)
+			{
+				memmove(&node->data[index + str.size], &node->data[index], node->length - index);
+				memcpy(&node->data[index], str.data, str.size);
+				node->length += str.size;
+			};
+		}
+		else
+			node->right = insert_in_place(rope, node->right, index - left_size - node->length, str, inserted);
+
+		if(*inserted)
+			node->size += str.size;
+	};
+
+	return node;
+}
+
+//	Remove count characters from index, which must all be within one chunk.
+static void delete_in_place(node_t* node, int index, int count)
+{
+	int left_size = size_of(node->left);
+
+	if(index < left_size)
+		delete_in_place(node->left, index, count);
+	else if(index < left_size + node->length)
+	{
+		index -= left_size;
+		memmove(&node->data[index], &node->data[index + count], node->length - index - count);
+		node->length -= count;
+	}
+	else
+		delete_in_place(node->right, index - left_size - node->length, count);
+
+	node->size -= count;
+}
+
+//	Join the chunk at index (or the last chunk if index is the end) with underfull neighbours, and trim each of their allocations to fit.
+//	The chunks are detached from the tree to do this, so they may be reallocated, then merged back in.
+static void coalesce(strrope_t* rope, int index)
+{
+	node_t* left;
+	node_t* right;
+	node_t* prev;
+	node_t* chunk;
+	node_t* next;
+	node_t* trimmed;
+	node_t** pieces[3] = {&prev, &chunk, &next};
+	int start;
+	int i;
+
+	if(rope->root)
+	{
+		if(index >= strrope_size(rope))
+			index = strrope_size(rope) - 1;
+
+		find_chunk(rope->root, index, &start);
+		split(rope->root, start, &left, &right, NULL);
+		chunk = pop_first(&right);
+		prev = pop_last(&left);
+		next = pop_first(&right);
+
+		if(join_chunks(rope, &prev, &chunk))
+			join_chunks(rope, &prev, &next);
+		else
+			join_chunks(rope, &chunk, &next);
+
+		for(i = 0; i != 3; i++)
+		{
+			if(*pieces[i] && (*pieces[i])->capacity - (*pieces[i])->length >= CAPACITY_STEP)
+			{
+				trimmed = resize_node(rope, *pieces[i], (*pieces[i])->length);
+				if(trimmed)
+					*pieces[i] = trimmed;
+			};
+		};
+
+		rope->root = merge(merge(merge(merge(left, prev), chunk), next), right);
+	};
+}
+
+//	Append the second of two detached chunks to the first if either is underfull and they fit in one chunk. The second is then freed and set to NULL.
+static bool join_chunks(strrope_t* rope, node_t** first, node_t** second)
+{
+	node_t* joined = NULL;
+	int length;
+
+	if(*first && *second)
+	{
+		length = (*first)->length + (*second)->length;
+		if(length <= STRROPE_CHUNK_SIZE && ((*first)->length < MIN_FILL || (*second)->length < MIN_FILL))
+			joined = resize_node(rope, *first, length);
+	};
+
+	if(joined)
+	{
+		memcpy(&joined->data[joined->length], (*second)->data, (*second)->length);
+		joined->length += (*second)->length;
+		update(joined);
+		rope->allocator.allocator(&rope->allocator, *second, 0);
+		*first = joined;
+		*second = NULL;
+	};
+
+	return !!joined;
+}
+
+//	Remove and return the first chunk of a tree, or NULL if the tree is empty.
+static node_t* pop_first(node_t** tree)
+{
+	node_t* node = *tree;
+	node_t* first = node;
+
+	if(node && node->left)
+	{
+		first = pop_first(&node->left);
+		update(node);
+	}
+	else if(node)
+	{
+		*tree = node->right;
+		node->right = NULL;
+		update(node);
+	};
+
+	return first;
+}
+
+//	Remove and return the last chunk of a tree, or NULL if the tree is empty.
+static node_t* pop_last(node_t** tree)
+{
+	node_t* node = *tree;
+	node_t* last = node;
+
+	if(node && node->right)
+	{
+		last = pop_last(&node->right);
+		update(node);
+	}
+	else if(node)
+	{
+		*tree = node->left;
+		node->left = NULL;
+		update(node);
+	};
+
+	return last;
+}
+
+//	Split a tree into everything before index, and everything from index onwards.
+//	If index falls within a chunk, *spare is used for the second part of it, and set to NULL. spare may be NULL if index is on a chunk boundary.
+static void split(node_t* node, int index, node_t** left, node_t** right, node_t** spare)
+{
+	node_t* tail;
+	int left_size;
+
+	if(!node)
+	{
+		*left = NULL;
+		*right = NULL;
+	}
+	else
+	{
+		left_size = size_of(node->left);
+		if(index <= left_size)
+		{
+			split(node->left, index, left, &node->left, spare);
+			update(node);
+			*right = node;
+		}
+		else if(index >= left_size + node->length)
+		{
+			split(node->right, index - left_size - node->length, &node->right, right, spare);
+			update(node);
+			*left = node;
+		}
+		else
+		{
+			// the tail of the chunk moves to the spare, which takes this node's priority so both trees remain heaps
+			index -= left_size;
+			tail = *spare;
+			*spare = NULL;
+			tail->length = node->length - index;
+			memcpy(tail->data, &node->data[index], tail->length);
+			tail->priority = node->priority;
+			tail->left = NULL;
+			tail->right = node->right;
+			update(tail);
+
+			node->length = index;
+			node->right = NULL;
+			update(node);
+
+			*left = node;
+			*right = tail;
+		};
+	};
+}
+
+static node_t* merge(node_t* left, node_t* right)
+{
+	node_t* result;
+
+	if(!left)
+		result = right;
+	else if(!right)
+		result = left;
+	else if(left->priority > right->priority)
+	{
+		left->right = merge(left->right, right);
+		update(left);
+		result = left;
+	}
+	else
+	{
+		right->left = merge(left, right->left);
+		update(right);
+		result = right;
+	};
+
+	return result;
+}
+
+static void update(node_t* node)
+{
+	node->size = size_of(node->left) + node->length + size_of(node->right);
+}
+
+static int size_of(node_t* node)
+{
+	return node ? node->size : 0;
+}
+
+static void append_tree_to_buf(node_t* node, strbuf_t** buf_ptr)
+{
+	strview_t chunk;
+
+	while(node)
+	{
+		append_tree_to_buf(node->left, buf_ptr);
+		chunk.data = node->data;
+		chunk.size = node->length;
+		strbuf_append(buf_ptr, chunk);
+		node = node->right;
+	};
+}
+
+//	xorshift32
+static uint32_t next_priority(strrope_t* rope)
+{
+	uint32_t x = rope->seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rope->seed = x;
+	return x;
+}
+
+static int clamp_index(strrope_t* rope, int index)
+{
+	int size = strrope_size(rope);
+
+	if(index > size)
+		index = size;
+	if(index < 0)
+		index += size;
+	if(index < 0)
+		index = 0;
+
+	return index;
+}
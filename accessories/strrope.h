@@ -0,0 +1,144 @@
+/**
+ * @file strrope.h
+ * @brief An accessory to strbuf.h providing a rope, for editing large strings without moving their contents.
+ * @author Michael Clift
+ *
+ * The contents of a rope are held in chunks of up to STRROPE_CHUNK_SIZE, which are the nodes of a balanced tree (a treap).
+ * Each chunk is allocated to fit it's contents, and grows in place until it is full. Deleting within a chunk also happens in place,
+ * and after a delete or split, neighbouring chunks are joined when one is less than half full, so the number of chunks stays in proportion to the size of the contents.
+ * Insert, delete and split are O(log n) in the number of chunks, independent of the size of the contents that follow.
+ * The contents are read as a sequence of strview_t chunks using strrope_chunk(), or flattened with strrope_to_strbuf().
+ *
+ * All memory is obtained from a strbuf_allocator_t.
+ *
+ * Example:
+ * @code{.c}
+ * strrope_t rope;
+ * strview_t chunk;
+ * int pos = 0;
+ *
+ * strrope_init(&rope, NULL);
+ * strrope_insert(&rope, 0, cstr("Hello World"));
+ * strrope_insert(&rope, 5, cstr(","));
+ * strrope_delete(&rope, 0, 1);
+ * strrope_insert(&rope, 0, cstr("J"));
+ *
+ * while((chunk = strrope_chunk(&rope, pos)).size)
+ * {
+ * 	printf("%.*s", chunk.size, chunk.data);
+ * 	pos += chunk.size;
+ * };
+ *
+ * strrope_destroy(&rope);
+ * @endcode
+ *
+ * ## Build options
+ * -DSTRROPE_CHUNK_SIZE=[size]
+ * The maximum capacity of each chunk. Defaults to 1024.
+ *
+ */
+
+#ifndef _STRROPE_H_
+	#define _STRROPE_H_
+
+	#include <stdbool.h>
+	#include <stdint.h>
+	#include "strview.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+	#ifndef STRROPE_CHUNK_SIZE
+		#define STRROPE_CHUNK_SIZE	1024
+	#endif
+
+/**
+ * @struct strrope_t
+ * @brief A rope instance. The members should be treated as read only.
+ **********************************************************************************/
+	typedef struct strrope_t
+	{
+		strbuf_allocator_t allocator;		///< The allocator used for chunks.
+		struct strrope_node_t* root;		///< The root of the tree, or NULL if the rope is empty.
+		uint32_t seed;						///< State for generating node priorities.
+	} strrope_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Initialize an empty rope.
+ * @param rope The rope to initialize.
+ * @param allocator A pointer to a strbuf_allocator_t which provides the allocator to use, or NULL to use the default allocator.
+ **********************************************************************************/
+	void strrope_init(strrope_t* rope, strbuf_allocator_t* allocator);
+
+/**
+ * @brief Free all memory held by a rope, leaving it empty.
+ * @param rope The rope.
+ **********************************************************************************/
+	void strrope_destroy(strrope_t* rope);
+
+/**
+ * @brief Get the size of the ropes contents.
+ * @param rope The rope.
+ * @return The total number of characters held.
+ **********************************************************************************/
+	int strrope_size(strrope_t* rope);
+
+/**
+ * @brief Insert a string into a rope.
+ * @param rope The rope.
+ * @param index The position to insert at. A negative index is relative to the end of the rope, an index beyond the end appends.
+ * @param str The string to insert, which may not be sourced from the rope itself.
+ * @return True if successful, false if memory could not be allocated, in which case the rope is unchanged.
+ **********************************************************************************/
+	bool strrope_insert(strrope_t* rope, int index, strview_t str);
+
+/**
+ * @brief Remove characters from a rope.
+ * @param rope The rope.
+ * @param index The position of the first character to remove.
+ * @param size The number of characters to remove, this is limited to the end of the rope.
+ * @return True, as removing characters never requires more memory.
+ **********************************************************************************/
+	bool strrope_delete(strrope_t* rope, int index, int size);
+
+/**
+ * @brief Split a rope in two.
+ * @param rope The rope, which will retain the contents before index.
+ * @param index The position to split at.
+ * @param tail An uninitialized rope, which will receive the contents from index onwards, and use the same allocator.
+ * @return True if successful, false if memory could not be allocated, in which case the rope is unchanged and tail is empty.
+ **********************************************************************************/
+	bool strrope_split(strrope_t* rope, int index, strrope_t* tail);
+
+/**
+ * @brief Append the contents of one rope to another, without copying.
+ * @param rope The rope to append to.
+ * @param tail The rope to append, which will be empty after the operation.
+ * @note Both ropes must use the same allocator.
+ **********************************************************************************/
+	void strrope_join(strrope_t* rope, strrope_t* tail);
+
+/**
+ * @brief Get a view of the chunk at a given position.
+ * @param rope The rope.
+ * @param index The position within the rope.
+ * @return A view from index to the end of the chunk containing it, or STRVIEW_INVALID if index is outside of the rope.
+ * @note The view is valid until the rope is next modified.
+ **********************************************************************************/
+	strview_t strrope_chunk(strrope_t* rope, int index);
+
+/**
+ * @brief Assign the contents of a rope to a buffer.
+ * @param rope The rope.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @return A view of the buffer contents, or STRVIEW_INVALID if the buffer is of fixed capacity and insufficient, in which case it is emptied.
+ **********************************************************************************/
+	strview_t strrope_to_strbuf(strrope_t* rope, strbuf_t** buf_ptr);
+
+#endif
@@ -0,0 +1,94 @@
+/*
+*/
+	#include <stdbool.h>
+	#include "strshared.h"
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Local defines
+//********************************************************************************************************
+
+//	A shared string is a dynamic strbuf_t, with the capacity member holding the reference count instead.
+	#define BUF_OF(str)	((strbuf_t*)(str))
+
+//********************************************************************************************************
+// Private prototypes
+//********************************************************************************************************
+
+	static strshared_t* share_buf(strbuf_t* buf);
+
+//********************************************************************************************************
+// Public functions
+//********************************************************************************************************
+
+strshared_t* strshared_create(strview_t str, strbuf_allocator_t* allocator)
+{
+	strshared_t* result = NULL;
+	if(strview_is_valid(str))
+		result = share_buf(strbuf_create_init(str, allocator));
+	return result;
+}
+
+strshared_t* strshared_from_buf(strbuf_t** buf_ptr)
+{
+	strshared_t* result = NULL;
+	strbuf_t* buf;
+	if(buf_ptr && *buf_ptr)
+	{
+		buf = *buf_ptr;
+		if(!buf->allocator.allocator)
+			result = strshared_create(strbuf_view(&buf), NULL);
+		else if(strbuf_is_hybrid(buf))	// still using it's fixed storage, so can't be taken
+			result = strshared_create(strbuf_view(&buf), buf->allocator.app_data);
+		else
+		{
+			strbuf_shrink(&buf);
+			result = share_buf(buf);
+			buf = NULL;
+		};
+		strbuf_destroy(&buf);
+		*buf_ptr = NULL;
+	};
+	return result;
+}
+
+strshared_t* strshared_retain(strshared_t* str)
+{
+	if(str)
+		__atomic_fetch_add(&BUF_OF(str)->capacity, 1, __ATOMIC_RELAXED);
+	return str;
+}
+
+void strshared_release(strshared_t** str_ptr)
+{
+	strbuf_t* buf;
+	if(str_ptr && *str_ptr)
+	{
+		buf = BUF_OF(*str_ptr);
+		if(__atomic_sub_fetch(&buf->capacity, 1, __ATOMIC_ACQ_REL) == 0)
+			buf->allocator.allocator(&buf->allocator, buf, 0);
+		*str_ptr = NULL;
+	};
+}
+
+strview_t strshared_view(const strshared_t* str)
+{
+	strview_t result = STRVIEW_INVALID;
+	if(str)
+	{
+		result.data = BUF_OF(str)->cstr;
+		result.size = BUF_OF(str)->size;
+	};
+	return result;
+}
+
+//********************************************************************************************************
+// Private functions
+//********************************************************************************************************
+
+static strshared_t* share_buf(strbuf_t* buf)
+{
+	if(buf)
+		buf->capacity = 1;
+	return (strshared_t*)buf;
+}
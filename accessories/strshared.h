@@ -0,0 +1,83 @@
+/**
+ * @file strshared.h
+ * @brief An accessory to strbuf.h for immutable strings, which may be shared between threads without copying.
+ * @author Michael Clift
+ *
+ * A view may not outlive the buffer it refers to, so passing text to another thread, or keeping it in a cache, would otherwise need a copy for every holder.
+ * A strshared_t holds text which never changes, and is freed when the last holder releases it. Retaining and releasing use atomic operations, and may be done from any thread.
+ *
+ * A shared string may be created from a dynamic buffer without copying it's contents, the buffer simply becomes the shared string.
+ * A buffer of fixed capacity, or a hybrid buffer which has not yet moved, is copied instead.
+ *
+ * Example:
+ * @code{.c}
+ * strbuf_t* buf = strbuf_create_init(cstr("timeout=30"), NULL);
+ * strshared_t* config = strshared_from_buf(&buf);		// buf is now NULL
+ *
+ * strshared_t* worker_copy = strshared_retain(config);	// pass worker_copy to another thread
+ * printf("%s\n", strshared_view(config).data);		// "timeout=30"
+ *
+ * strshared_release(&config);
+ * strshared_release(&worker_copy);						// text is freed here
+ * @endcode
+ *
+ */
+
+#ifndef _STRSHARED_H_
+	#define _STRSHARED_H_
+
+	#include "strbuf.h"
+
+//********************************************************************************************************
+// Public defines
+//********************************************************************************************************
+
+/**
+ * @struct strshared_t
+ * @brief An immutable reference counted string. The contents are private, use strshared_view() to access the text.
+ **********************************************************************************/
+	typedef struct strshared_t strshared_t;
+
+//********************************************************************************************************
+// Public prototypes
+//********************************************************************************************************
+
+/**
+ * @brief Create a shared string by copying a view.
+ * @param str The text to copy.
+ * @param allocator A pointer to a strbuf_allocator_t which provides the allocator to use, or NULL to use the default allocator.
+ * @return The shared string with a reference count of 1, or NULL if str is invalid or memory could not be allocated.
+ **********************************************************************************/
+	strshared_t* strshared_create(strview_t str, strbuf_allocator_t* allocator);
+
+/**
+ * @brief Create a shared string from a buffer, taking ownership of the buffer.
+ * @param buf_ptr The address of a pointer to the buffer, which will be set to NULL.
+ * @return The shared string with a reference count of 1, or NULL if memory could not be allocated.
+ * @note A dynamic buffer is shrunk to fit it's contents, and becomes the shared string without copying.
+ * @note The contents of a buffer of fixed capacity are copied using the default allocator, and the contents of a hybrid buffer which has not yet moved are copied using it's fallback allocator.
+ **********************************************************************************/
+	strshared_t* strshared_from_buf(strbuf_t** buf_ptr);
+
+/**
+ * @brief Add a reference to a shared string.
+ * @param str The shared string, or NULL.
+ * @return str, for convenience when passing a reference to a new holder.
+ **********************************************************************************/
+	strshared_t* strshared_retain(strshared_t* str);
+
+/**
+ * @brief Remove a reference to a shared string, freeing it if this was the last reference.
+ * @param str_ptr The address of a pointer to the shared string, which will be set to NULL.
+ **********************************************************************************/
+	void strshared_release(strshared_t** str_ptr);
+
+/**
+ * @brief Get a view of the text held by a shared string.
+ * @param str The shared string.
+ * @return A view of the text, which is also null terminated, or STRVIEW_INVALID if str is NULL.
+ * @note The view remains valid while the caller holds a reference.
+ **********************************************************************************/
+	strview_t strshared_view(const strshared_t* str);
+
+#endif
@@ -2,16 +2,27 @@
 */
 	#include <limits.h>
 	#include <unistd.h>
+	#include <sys/uio.h>
+	#include "strview_io.h"
 	#include "strview.h"
 
 //********************************************************************************************************
 // Local defines
 //********************************************************************************************************
 
+	// the number of views sent per writev() call, kept small as the iovec array is on the stack
+	#if defined(IOV_MAX) && IOV_MAX < 64
+		#define IOV_BATCH IOV_MAX
+	#else
+		#define IOV_BATCH 64
+	#endif
+
 //********************************************************************************************************
 // Private prototypes
 //********************************************************************************************************
 
+	static int advance_views(strview_t views[], int count, int written);
+
 //********************************************************************************************************
 // Public functions
 //********************************************************************************************************
@@ -30,7 +41,81 @@ int strview_write(int fd, strview_t* src)
 	return retval;
 }
 
+int strview_writev(int fd, strview_t views[], int count)
+{
+	struct iovec iov[IOV_BATCH];
+	int iov_count;
+	int batch_size;
+	int total = 0;
+	int first = 0;
+	int last;
+	ssize_t written = 0;
+	bool done = false;
+
+	while(!done)
+	{
+		// gather the next batch, skipping views with nothing to write
+		while(first != count && !(strview_is_valid(views[first]) && views[first].size))
+			first++;
+
+		iov_count = 0;
+		batch_size = 0;
+		last = first;
+		while(last != count && iov_count != IOV_BATCH && batch_size <= INT_MAX - total - views[last].size)
+		{
+			if(strview_is_valid(views[last]) && views[last].size)
+			{
+				iov[iov_count].iov_base = (void*)views[last].data;
+				iov[iov_count].iov_len = views[last].size;
+				iov_count++;
+				batch_size += views[last].size;
+			};
+			last++;
+		};
+
+		done = !iov_count;
+		if(!done)
+		{
+			written = writev(fd, iov, iov_count);
+			if(written > 0)
+			{
+				first = advance_views(&views[first], last - first, written) + first;
+				total += written;
+			};
+			done = written != batch_size;
+		};
+	};
+
+	return (written < 0 && !total) ? -1 : total;
+}
+
 //********************************************************************************************************
 // Private functions
 //********************************************************************************************************
 
+//	Remove the number of bytes written from the views, returns the index of the first view not completely written
+static int advance_views(strview_t views[], int count, int written)
+{
+	int i = 0;
+	int size;
+
+	while(i != count && written)
+	{
+		size = strview_is_valid(views[i]) ? views[i].size : 0;
+		if(size > written)
+			size = written;
+		written -= size;
+		if(!strview_is_valid(views[i]))
+			i++;
+		else if(size == views[i].size)
+		{
+			views[i] = (strview_t){.data = views[i].data + views[i].size, .size = 0};
+			i++;
+		}
+		else
+			views[i] = strview_sub(views[i], size, INT_MAX);
+	};
+
+	return i;
+}
+
@@ -28,4 +28,17 @@
    **********************************************************************************/
 	int strview_write(int fd, strview_t* src);
 
+/**
+ * @brief Attempt to write the contents of an array of views using POSIX writev(), and remove the number of bytes written from each view.
+ * @param fd The file descriptor to write to.
+ * @param views The array of views.
+ * @param count The number of views in the array.
+ * @return The total number of bytes written, or -1 for error with errno set.
+ * @note Views are sent in batches of up to 64 (or IOV_MAX if smaller). A further batch is only sent if the previous batch was written completely.
+ * @note Views which have been written completely are left empty, a partially written view is advanced past the bytes written.
+ * @note Invalid and empty views are skipped, writev() will NOT be called if there is nothing to write.
+ * @note If an error occurs after some bytes have been written, the number of bytes written is returned.
+   **********************************************************************************/
+	int strview_writev(int fd, strview_t views[], int count);
+
 #endif
@@ -6,6 +6,10 @@
 	#include "strview.h"
 	#include "strbuf.h"
 
+	#ifdef STRBUF_PROVIDE_STRNUM
+		#include "strnum.h"
+	#endif
+
 	#ifdef STRBUF_PROVIDE_PRINTF
 		#include <stdio.h>
 	#endif
@@ -18,6 +22,10 @@
 		#include <stdlib.h>
 	#endif
 
+	#if defined(STRBUF_DEFAULT_ALLOCATOR_STDLIB) && defined(STRBUF_DEFAULT_ALLOCATOR_USABLE_SIZE)
+		#include <malloc.h>
+	#endif
+
 	#ifdef STRBUF_ASSERT_DEFAULT_ALLOCATOR_STDLIB
 		#include <assert.h>
 	#endif
@@ -31,10 +39,30 @@
 		#define STRBUF_CAPACITY_GROW_RATIO 1
 	#endif
 
+	#ifndef STRBUF_PAGE_SIZE
+		#define STRBUF_PAGE_SIZE 4096
+	#endif
+
+	#ifdef STRBUF_CAPACITY_HOOK
+		void STRBUF_CAPACITY_HOOK(strbuf_t* buf, int old_capacity);
+	#endif
+
 //********************************************************************************************************
 // Local defines
 //********************************************************************************************************
 
+//	The bits of a growth policy holding STRBUF_GROWTH_RATIO(n)
+	#define GROWTH_RATIO_MASK	0x0F
+
+//	Character conversions applied by convert_chars()
+	enum {CONVERT_UPPER, CONVERT_LOWER, CONVERT_TABLE};
+
+//	A byte of 0x01 in every position of a word, for converting 8 characters at a time
+	#define BYTES_OF_ONE	0x0101010101010101ULL
+
+//	Space for a double formatted by strbuf_catx(), including the terminator
+	#define CATX_DOUBLE_SIZE	32
+
 //	#include <stdio.h>
 //	#define DBG(_fmtarg, ...) printf("%s:%.4i - "_fmtarg"\n" , __FILE__, __LINE__ ,##__VA_ARGS__)
 
@@ -47,22 +75,40 @@
 	static void insert_strview_into_buf(strbuf_t** buf_ptr, int index, strview_t str);
 	static void destroy_buf(strbuf_t** buf_ptr);
 	static void change_buf_capacity(strbuf_t** buf_ptr, int new_capacity);
+	static void move_hybrid_buf(strbuf_t** buf_ptr, int new_capacity);
+	static void* hybrid_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
 	static void assign_strview_to_buf(strbuf_t** buf_ptr, strview_t str);
 	static void append_char_to_buf(strbuf_t** strbuf, char c);
-	static int  round_up_capacity(int current_capacity, int capacity_needed);
+	static int  round_up_capacity(int growth, int current_capacity, int capacity_needed);
+	static int  usable_capacity(strbuf_t* buf, int capacity_requested);
 	static strview_t strview_of_buf(strbuf_t* buf);
 	static bool buf_contains_str(strbuf_t* buf, strview_t str);
 	static bool buf_is_dynamic(strbuf_t* buf);
+	static bool buf_is_hybrid(strbuf_t* buf);
 	static void empty_buf(strbuf_t* buf);
 	static bool add_will_overflow_int(int a, int b);
-	static bool view_contains_char(strview_t view, char c);
+	static void strip_set_from_buf(strbuf_t* buf, const uint8_t set[32]);
+	static strview_t assign_converted(strbuf_t** buf_ptr, strview_t str, int conversion, const char table[256]);
+	static void convert_chars(char* dst, const char* src, int size, int conversion, const char table[256]);
+	static uint64_t convert_case_of_word(uint64_t word, char first, char last);
+	static int catx_double_count(int count, const strbuf_catx_arg_t args[count]);
+	static int catx_arg_size(const strbuf_catx_arg_t* arg, char* text);
+	static void write_catx_args(char* dst, int count, const strbuf_catx_arg_t args[count], const char (*doubles)[CATX_DOUBLE_SIZE]);
+	static int decimal_digits(unsigned long long value);
+	static void write_decimal(char* dst, int digits, unsigned long long value);
+	static strview_t replace_all(strbuf_t** buf_ptr, strview_t find, strview_t replace, bool nocase);
+	static void replace_in_buf(strbuf_t* buf, strview_t find, strview_t replace, int new_size, bool nocase);
+	static strview_t find_next(strview_t haystack, strview_t needle, bool nocase);
 
 #ifdef STRBUF_PROVIDE_PRNF
-	static void char_handler_for_prnf(void* dst, char c);
+	static void span_handler_for_prnf(void* dst, const char* data, int size);
 #endif
 
 #ifdef STRBUF_DEFAULT_ALLOCATOR_STDLIB
 	static void* allocfunc_stdlib(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+	#ifdef STRBUF_DEFAULT_ALLOCATOR_USABLE_SIZE
+		static size_t usable_size_stdlib(struct strbuf_allocator_t* this_allocator, void* ptr);
+	#endif
 #endif
 
 //********************************************************************************************************
@@ -83,7 +129,16 @@ static void* allocfunc_stdlib(struct strbuf_allocator_t* this_allocator, void* p
 	#endif
 	return result;
 }
+	#ifdef STRBUF_DEFAULT_ALLOCATOR_USABLE_SIZE
+static size_t usable_size_stdlib(struct strbuf_allocator_t* this_allocator, void* ptr)
+{
+	(void)this_allocator;
+	return malloc_usable_size(ptr);
+}
+	strbuf_allocator_t strbuf_default_allocator = (strbuf_allocator_t){.allocator=allocfunc_stdlib, .usable_size=usable_size_stdlib, .app_data=NULL};
+	#else
 	strbuf_allocator_t strbuf_default_allocator = (strbuf_allocator_t){.allocator=allocfunc_stdlib, .app_data=NULL};
+	#endif
 #else
 	#pragma weak strbuf_default_allocator
 	strbuf_allocator_t strbuf_default_allocator = (strbuf_allocator_t){.allocator=NULL, .app_data=NULL};
@@ -137,6 +192,8 @@ strbuf_t* strbuf_create_fixed(void* addr, size_t addr_size)
 			result = addr;
 			result->allocator.app_data = NULL;
 			result->allocator.allocator = NULL;
+			result->allocator.usable_size = NULL;
+			result->allocator.growth = 0;
 			result->capacity =  capacity <= INT_MAX ? capacity:INT_MAX;
 			result->size = 0;
 			empty_buf(result);
@@ -146,6 +203,26 @@ strbuf_t* strbuf_create_fixed(void* addr, size_t addr_size)
 	return result;
 }
 
+strbuf_t* strbuf_create_hybrid(strbuf_t* fixed_buf, strbuf_allocator_t* fallback)
+{
+	if(!fallback)
+		fallback = &strbuf_default_allocator;
+
+	if(fixed_buf && !buf_is_dynamic(fixed_buf) && fallback->allocator)
+	{
+		fixed_buf->allocator.allocator = hybrid_allocfunc;
+		fixed_buf->allocator.app_data = fallback;
+		fixed_buf->allocator.growth = fallback->growth;
+	};
+
+	return fixed_buf;
+}
+
+bool strbuf_is_hybrid(strbuf_t* buf)
+{
+	return buf && buf_is_hybrid(buf);
+}
+
 // concatenate a number of str's this can include the buffer itself, strbuf.str for appending
 strview_t _strbuf_cat(strbuf_t** buf_ptr, int n_args, ...)
 {
@@ -166,6 +243,77 @@ strview_t strbuf_vcat(strbuf_t** buf_ptr, int n_args, va_list va)
 	return str;
 }
 
+strview_t _strbuf_catx(strbuf_t** buf_ptr, int count, const strbuf_catx_arg_t args[count])
+{
+	strbuf_t* buf;
+	strbuf_t* tmp_buf;
+	int size_needed = 0;
+	int size;
+	int first = 0;
+	int start = 0;
+	bool tmp_buf_needed = false;
+	bool failed = false;
+	int n_doubles = 0;
+	int i = 0;
+	// doubles are formatted once while measuring, and copied from here when writing
+	char doubles[catx_double_count(count, args) + 1][CATX_DOUBLE_SIZE];
+
+	if(buf_ptr && *buf_ptr)
+	{
+		buf = *buf_ptr;
+
+		// if the first argument is the start of the buffers contents, it can stay where it is
+		if(count && args[0].type == STRBUF_CATX_VIEW && args[0].view.data == buf->cstr && args[0].view.size <= buf->size)
+		{
+			start = args[0].view.size;
+			first = 1;
+		};
+
+		while(i != count && !failed)
+		{
+			size = catx_arg_size(&args[i], doubles[n_doubles]);
+			n_doubles += args[i].type == STRBUF_CATX_DOUBLE;
+			failed = size < 0 || add_will_overflow_int(size_needed, size);
+			size_needed += size;
+			if(i >= first && args[i].type == STRBUF_CATX_VIEW)
+				tmp_buf_needed |= buf_contains_str(buf, args[i].view);
+			i++;
+		};
+
+		if(!failed && tmp_buf_needed)
+		{
+			failed = !buf_is_dynamic(buf);
+			if(!failed)
+			{
+				tmp_buf = create_buf(size_needed, buf->allocator);
+				write_catx_args(tmp_buf->cstr, count, args, doubles);
+				tmp_buf->size = size_needed;
+				assign_strview_to_buf(&buf, strview_of_buf(tmp_buf));
+				destroy_buf(&tmp_buf);
+			};
+		}
+		else if(!failed)
+		{
+			if(buf_is_dynamic(buf) && buf->capacity < size_needed)
+				change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, size_needed));
+			failed = buf->capacity < size_needed;
+			if(!failed)
+			{
+				write_catx_args(&buf->cstr[start], count - first, &args[first], doubles);
+				buf->size = size_needed;
+				buf->cstr[buf->size] = 0;
+			};
+		};
+
+		if(failed)
+			empty_buf(buf);
+
+		*buf_ptr = buf;
+	};
+
+	return buf_ptr ? strview_of_buf(*buf_ptr) : STRVIEW_INVALID;
+}
+
 #ifdef STRBUF_PROVIDE_PRINTF
 strview_t strbuf_printf(strbuf_t** buf_ptr, const char* format, ...)
 {
@@ -225,7 +373,7 @@ strview_t strbuf_append_vprintf(strbuf_t** buf_ptr, const char* format, va_list
 		{
 			size += append_size;
 			if(buf_is_dynamic(buf) && size > buf->capacity)
-				change_buf_capacity(&buf, round_up_capacity(buf->size, size));
+				change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, size));
 
 			failed = size > buf->capacity;
 		};
@@ -267,7 +415,7 @@ strview_t strbuf_vprnf(strbuf_t** buf_ptr, const char* format, va_list va)
 		buf = *buf_ptr;
 		empty_buf(buf);
 
-		char_count = vfptrprnf(char_handler_for_prnf, &buf,  format, va);
+		char_count = vspanprnf(span_handler_for_prnf, &buf,  format, va);
 
 		if(char_count > buf->size)
 			empty_buf(buf);
@@ -301,7 +449,7 @@ strview_t strbuf_append_vprnf(strbuf_t** buf_ptr, const char* format, va_list va
 		buf = *buf_ptr;
 
 		char_count = buf->size;
-		char_count += vfptrprnf(char_handler_for_prnf, &buf,  format, va);
+		char_count += vspanprnf(span_handler_for_prnf, &buf,  format, va);
 
 		if(char_count > buf->size || char_count < 0)
 			empty_buf(buf);
@@ -333,6 +481,41 @@ strview_t strbuf_append_char(strbuf_t** buf_ptr, char c)
 	return str;
 }
 
+char* strbuf_reserve(strbuf_t** buf_ptr, int size)
+{
+	char* space = NULL;
+	strbuf_t* buf;
+	if(buf_ptr && *buf_ptr && size >= 0 && !add_will_overflow_int((*buf_ptr)->size, size))
+	{
+		buf = *buf_ptr;
+		if(buf_is_dynamic(buf) && buf->capacity < buf->size + size)
+			change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, buf->size + size));
+		if(buf->capacity >= buf->size + size)
+			space = &buf->cstr[buf->size];
+		*buf_ptr = buf;
+	};
+	return space;
+}
+
+strview_t strbuf_commit(strbuf_t** buf_ptr, int size)
+{
+	strview_t str = STRVIEW_INVALID;
+	strbuf_t* buf;
+	if(buf_ptr && *buf_ptr)
+	{
+		buf = *buf_ptr;
+		if(size > buf->capacity - buf->size)
+			size = buf->capacity - buf->size;
+		if(size > 0)
+		{
+			buf->size += size;
+			buf->cstr[buf->size] = 0;
+		};
+		str = strview_of_buf(buf);
+	};
+	return str;
+}
+
 // reduce allocation size to the minimum possible
 strview_t strbuf_shrink(strbuf_t** buf_ptr)
 {
@@ -362,6 +545,12 @@ strview_t strbuf_grow(strbuf_t** buf_ptr, int min_size)
 	return str;
 }
 
+void strbuf_set_growth(strbuf_t** buf_ptr, int growth)
+{
+	if(buf_ptr && *buf_ptr && buf_is_dynamic(*buf_ptr))
+		(*buf_ptr)->allocator.growth = growth;
+}
+
 void strbuf_destroy(strbuf_t** buf_ptr)
 {
 	if(buf_ptr)
@@ -380,17 +569,26 @@ char* strbuf_to_cstr(strbuf_t** buf_ptr)
 	if(buf_ptr && *buf_ptr)
 	{
 		len = (*buf_ptr)->size;
-		if(buf_is_dynamic(*buf_ptr))
-		{
-			allocator = (*buf_ptr)->allocator;
-			str = (void*)(*buf_ptr);
-			memmove(str, (*buf_ptr)->cstr, len);
-			str = allocator.allocator(&allocator, str, len+1);
-		}
+		if(buf_is_hybrid(*buf_ptr))
+			move_hybrid_buf(buf_ptr, len);
+
+		if(buf_is_hybrid(*buf_ptr))
+			str = NULL;	// unable to move, the buffer is left intact
 		else
-			str = (*buf_ptr)->cstr;
-		str[len] = 0;
-		*buf_ptr = NULL;
+		{
+			if(buf_is_dynamic(*buf_ptr))
+			{
+				allocator = (*buf_ptr)->allocator;
+				str = (void*)(*buf_ptr);
+				memmove(str, (*buf_ptr)->cstr, len);
+				str = allocator.allocator(&allocator, str, len+1);
+			}
+			else
+				str = (*buf_ptr)->cstr;
+			if(str)
+				str[len] = 0;
+			*buf_ptr = NULL;
+		};
 	};
 	return str;
 }
@@ -406,7 +604,7 @@ strview_t strbuf_assign(strbuf_t** buf_ptr, strview_t str)
 		if(!failed)
 		{
 			if(str.size > buf->capacity && buf_is_dynamic(buf))
-				change_buf_capacity(&buf, round_up_capacity(buf->size, str.size));
+				change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, str.size));
 			
 			failed = str.size > buf->capacity;
 		};
@@ -531,27 +729,17 @@ strview_t strbuf_insert_after_cstr(strbuf_t** buf_ptr, strview_t dst, const char
 
 strview_t strbuf_strip_strview(strbuf_t** buf_ptr, strview_t stripchars)
 {
-	strbuf_t* buf;
-	char* ptr;
-	int count;
+	uint8_t set[32] = {0};
+	unsigned char c;
 
 	if(buf_ptr && *buf_ptr && strview_is_valid(stripchars))
 	{
-		buf = *buf_ptr;
-		count = buf->size;
-		ptr = buf->cstr;
-		while(count)
+		while(stripchars.size--)
 		{
-			if(view_contains_char(stripchars, *ptr))
-			{
-				memmove(ptr, ptr+1, count);
-				buf->size--;
-			}
-			else
-				ptr++;
-			count--;
+			c = *stripchars.data++;
+			set[c >> 3] |= 1 << (c & 7);
 		};
-		*buf_ptr = buf;
+		strip_set_from_buf(*buf_ptr, set);
 	};
 
 	return buf_ptr ? strview_of_buf(*buf_ptr) : STRVIEW_INVALID;
@@ -562,6 +750,61 @@ strview_t strbuf_strip_cstr(strbuf_t** buf_ptr, const char* stripchars)
 	return strbuf_strip_strview(buf_ptr, cstr(stripchars));
 }
 
+strview_t strbuf_strip_if(strbuf_t** buf_ptr, int (*strip_char)(int c))
+{
+	uint8_t set[32] = {0};
+	int c;
+
+	if(buf_ptr && *buf_ptr && strip_char)
+	{
+		for(c = 0; c <= UCHAR_MAX; c++)
+			set[c >> 3] |= (!!strip_char(c)) << (c & 7);
+		strip_set_from_buf(*buf_ptr, set);
+	};
+
+	return buf_ptr ? strview_of_buf(*buf_ptr) : STRVIEW_INVALID;
+}
+
+strview_t strbuf_to_upper(strbuf_t** buf_ptr)
+{
+	return buf_ptr && *buf_ptr ? assign_converted(buf_ptr, strview_of_buf(*buf_ptr), CONVERT_UPPER, NULL) : STRVIEW_INVALID;
+}
+
+strview_t strbuf_to_lower(strbuf_t** buf_ptr)
+{
+	return buf_ptr && *buf_ptr ? assign_converted(buf_ptr, strview_of_buf(*buf_ptr), CONVERT_LOWER, NULL) : STRVIEW_INVALID;
+}
+
+strview_t strbuf_translate(strbuf_t** buf_ptr, const char table[256])
+{
+	return buf_ptr && *buf_ptr ? assign_converted(buf_ptr, strview_of_buf(*buf_ptr), CONVERT_TABLE, table) : STRVIEW_INVALID;
+}
+
+strview_t strbuf_assign_upper(strbuf_t** buf_ptr, strview_t str)
+{
+	return assign_converted(buf_ptr, str, CONVERT_UPPER, NULL);
+}
+
+strview_t strbuf_assign_lower(strbuf_t** buf_ptr, strview_t str)
+{
+	return assign_converted(buf_ptr, str, CONVERT_LOWER, NULL);
+}
+
+strview_t strbuf_assign_translated(strbuf_t** buf_ptr, strview_t str, const char table[256])
+{
+	return assign_converted(buf_ptr, str, CONVERT_TABLE, table);
+}
+
+strview_t strbuf_replace_all(strbuf_t** buf_ptr, strview_t find, strview_t replace)
+{
+	return replace_all(buf_ptr, find, replace, false);
+}
+
+strview_t strbuf_replace_all_nocase(strbuf_t** buf_ptr, strview_t find, strview_t replace)
+{
+	return replace_all(buf_ptr, find, replace, true);
+}
+
 strview_t strbuf_terminate_views(strbuf_t** buf_ptr, int count, strview_t src[count])
 {
 	bool failed;
@@ -657,11 +900,14 @@ static strbuf_t* create_buf(int initial_capacity, strbuf_allocator_t allocator)
 {
 	strbuf_t* buf = NULL;
 
+	if(allocator.allocator == hybrid_allocfunc)
+		allocator = *(strbuf_allocator_t*)allocator.app_data;
+
 	if(initial_capacity <= INT_MAX)
 	{
 		buf = allocator.allocator(&allocator, NULL, sizeof(strbuf_t)+initial_capacity+1);
-		buf->capacity = initial_capacity;
 		buf->allocator = allocator;
+		buf->capacity = usable_capacity(buf, initial_capacity);
 		empty_buf(buf);
 	};
 
@@ -706,7 +952,7 @@ static strview_t buffer_vcat(strbuf_t** buf_ptr, int n_args, va_list va)
 		else
 		{
 			if(buf_is_dynamic(dst_buf) && dst_buf->capacity < size_needed)
-				change_buf_capacity(&dst_buf, round_up_capacity(dst_buf->size, size_needed));
+				change_buf_capacity(&dst_buf, round_up_capacity(dst_buf->allocator.growth, dst_buf->size, size_needed));
 			build_buf = dst_buf;
 			empty_buf(build_buf);
 		};
@@ -759,7 +1005,7 @@ static void insert_strview_into_buf(strbuf_t** buf_ptr, int index, strview_t str
 	if(!failed)
 	{
 		if(buf_is_dynamic(buf) && buf->capacity < buf->size + str.size)
-			change_buf_capacity(&buf, round_up_capacity(buf->size, (buf->size + str.size)));
+			change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, (buf->size + str.size)));
 
 		if(src_in_dst && buf != *buf_ptr)
 			str.data = buf->cstr + src_offset;
@@ -800,7 +1046,7 @@ static void insert_strview_into_buf(strbuf_t** buf_ptr, int index, strview_t str
 static void destroy_buf(strbuf_t** buf_ptr)
 {
 	strbuf_t* buf = *buf_ptr;
-	if(buf_is_dynamic(buf))
+	if(buf_is_dynamic(buf) && !buf_is_hybrid(buf))
 		buf->allocator.allocator(&buf->allocator, buf, 0);
 	*buf_ptr = NULL;
 }
@@ -808,8 +1054,16 @@ static void destroy_buf(strbuf_t** buf_ptr)
 static void change_buf_capacity(strbuf_t** buf_ptr, int new_capacity)
 {
 	strbuf_t* buf = *buf_ptr;
+#ifdef STRBUF_CAPACITY_HOOK
+	int old_capacity = buf->capacity;
+#endif
 
-	if(buf_is_dynamic(buf))
+	if(buf_is_hybrid(buf))
+	{
+		if(new_capacity > buf->capacity)
+			move_hybrid_buf(&buf, new_capacity);
+	}
+	else if(buf_is_dynamic(buf))
 	{
 		if(new_capacity < buf->size)
 			new_capacity = buf->size;
@@ -817,10 +1071,48 @@ static void change_buf_capacity(strbuf_t** buf_ptr, int new_capacity)
 		if(new_capacity != buf->capacity)
 		{
 			buf = buf->allocator.allocator(&buf->allocator, buf, sizeof(strbuf_t)+new_capacity+1);
-			buf->capacity = new_capacity;
+			buf->capacity = usable_capacity(buf, new_capacity);
 		};
 	};
 	*buf_ptr = buf;
+
+#ifdef STRBUF_CAPACITY_HOOK
+	if(buf->capacity != old_capacity)
+		STRBUF_CAPACITY_HOOK(buf, old_capacity);
+#endif
+}
+
+//	Copy a hybrid buffer from it's fixed storage to the fallback allocator. On failure, the buffer remains where it is.
+static void move_hybrid_buf(strbuf_t** buf_ptr, int new_capacity)
+{
+	strbuf_t* buf = *buf_ptr;
+	strbuf_allocator_t* fallback = buf->allocator.app_data;
+	strbuf_t* new_buf;
+
+	if(new_capacity < buf->size)
+		new_capacity = buf->size;
+
+	new_buf = fallback->allocator(fallback, NULL, sizeof(strbuf_t)+new_capacity+1);
+	if(new_buf)
+	{
+		memcpy(new_buf->cstr, buf->cstr, buf->size+1);
+		new_buf->size = buf->size;
+		new_buf->allocator = *fallback;
+		new_buf->allocator.growth = buf->allocator.growth;
+		new_buf->capacity = usable_capacity(new_buf, new_capacity);
+		*buf_ptr = new_buf;
+	};
+}
+
+//	Identifies a hybrid buffer which has not yet moved, app_data points to the fallback allocator.
+//	The fixed storage is never freed or resized through this, only new allocations are passed to the fallback.
+static void* hybrid_allocfunc(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size)
+{
+	strbuf_allocator_t* fallback = this_allocator->app_data;
+	void* result = NULL;
+	if(!ptr_to_free && size)
+		result = fallback->allocator(fallback, NULL, size);
+	return result;
 }
 
 static void assign_strview_to_buf(strbuf_t** buf_ptr, strview_t str)
@@ -837,7 +1129,7 @@ static void append_char_to_buf(strbuf_t** buf_ptr, char c)
 	if(!failed)
 	{
 		if(buf_is_dynamic(buf) && buf->size+1 > buf->capacity)
-			change_buf_capacity(&buf, round_up_capacity(buf->size, buf->size + 1));
+			change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, buf->size + 1));
 		failed = buf->capacity < buf->size+1;
 	};
 
@@ -853,14 +1145,19 @@ static void append_char_to_buf(strbuf_t** buf_ptr, char c)
 	*buf_ptr = buf;
 }
 
-static int round_up_capacity(int current_capacity, int capacity_needed)
+static int round_up_capacity(int growth, int current_capacity, int capacity_needed)
 {
 	int grow_size;
 	int new_capacity = current_capacity;
+	int ratio = (growth & GROWTH_RATIO_MASK) ? (growth & GROWTH_RATIO_MASK) - 1 : STRBUF_CAPACITY_GROW_RATIO;
+	size_t alloc_size;
+
+	if(growth & STRBUF_GROWTH_EXACT)
+		new_capacity = capacity_needed;
 
 	while(new_capacity < capacity_needed)
 	{
-		grow_size = new_capacity >> STRBUF_CAPACITY_GROW_RATIO;
+		grow_size = new_capacity >> ratio;
 		if(!grow_size)
 			grow_size = 1;
 		if(!add_will_overflow_int(new_capacity, grow_size))
@@ -869,9 +1166,35 @@ static int round_up_capacity(int current_capacity, int capacity_needed)
 			new_capacity = INT_MAX;
 	};
 
+	alloc_size = sizeof(strbuf_t) + (size_t)new_capacity + 1;
+	if((growth & STRBUF_GROWTH_PAGED) && alloc_size > STRBUF_PAGE_SIZE)
+	{
+		alloc_size = (alloc_size + STRBUF_PAGE_SIZE - 1) / STRBUF_PAGE_SIZE * STRBUF_PAGE_SIZE;
+		alloc_size -= sizeof(strbuf_t) + 1;
+		new_capacity = alloc_size <= INT_MAX ? (int)alloc_size : INT_MAX;
+	};
+
 	return new_capacity;
 }
 
+//	The capacity of a newly (re)allocated buffer, which may be more than requested if the allocator reports it's usable size.
+static int usable_capacity(strbuf_t* buf, int capacity_requested)
+{
+	size_t usable = 0;
+	int capacity = capacity_requested;
+
+	if(buf->allocator.usable_size)
+		usable = buf->allocator.usable_size(&buf->allocator, buf);
+
+	if(usable > sizeof(strbuf_t) + (size_t)capacity_requested + 1)
+	{
+		usable -= sizeof(strbuf_t) + 1;
+		capacity = usable <= INT_MAX ? (int)usable : INT_MAX;
+	};
+
+	return capacity;
+}
+
 static bool buf_contains_str(strbuf_t* buf, strview_t str)
 {
 	return &buf->cstr[0] <= str.data && str.data < &buf->cstr[buf->size];
@@ -882,6 +1205,11 @@ static bool buf_is_dynamic(strbuf_t* buf)
 	return !!(buf->allocator.allocator);
 }
 
+static bool buf_is_hybrid(strbuf_t* buf)
+{
+	return buf->allocator.allocator == hybrid_allocfunc;
+}
+
 static void empty_buf(strbuf_t* buf)
 {
 	buf->size = 0;
@@ -890,31 +1218,348 @@ static void empty_buf(strbuf_t* buf)
 
 static bool add_will_overflow_int(int a, int b)
 {
-	int c = a;
-	c += b;
-	return ((a < 0) == (b < 0) && (a < 0) != (c < 0));
+	return b > 0 ? a > INT_MAX - b : a < INT_MIN - b;
+}
+
+static int catx_double_count(int count, const strbuf_catx_arg_t args[count])
+{
+	int n_doubles = 0;
+	while(count--)
+		n_doubles += args[count].type == STRBUF_CATX_DOUBLE;
+	return n_doubles;
+}
+
+//	The number of characters needed to format an argument to strbuf_catx(), or -1 if it can't be formatted
+//	A double is formatted into text, which must have space for CATX_DOUBLE_SIZE characters
+static int catx_arg_size(const strbuf_catx_arg_t* arg, char* text)
+{
+	int size = -1;
+
+	switch(arg->type)
+	{
+		case STRBUF_CATX_VIEW:
+			size = arg->view.size;
+			break;
+		case STRBUF_CATX_CHAR:
+			size = 1;
+			break;
+		case STRBUF_CATX_INT:
+			size = decimal_digits(arg->i < 0 ? -(unsigned long long)arg->i : (unsigned long long)arg->i) + (arg->i < 0);
+			break;
+		case STRBUF_CATX_UINT:
+			size = decimal_digits(arg->u);
+			break;
+		case STRBUF_CATX_DOUBLE:
+		#if defined(STRBUF_PROVIDE_STRNUM) && !defined(STRNUM_NOFLOAT)
+			size = strnum_format_double(text, CATX_DOUBLE_SIZE, arg->d, 0, 0);
+		#else
+			(void)text;
+		#endif
+			break;
+	};
+
+	return size;
+}
+
+//	Write arguments measured by catx_arg_size(), the doubles having been formatted in order into doubles[]
+static void write_catx_args(char* dst, int count, const strbuf_catx_arg_t args[count], const char (*doubles)[CATX_DOUBLE_SIZE])
+{
+	int i = 0;
+	int size;
+	unsigned long long magnitude;
+
+	while(i != count)
+	{
+		switch(args[i].type)
+		{
+			case STRBUF_CATX_VIEW:
+				if(args[i].view.size)
+					memmove(dst, args[i].view.data, args[i].view.size);
+				dst += args[i].view.size;
+				break;
+			case STRBUF_CATX_CHAR:
+				*dst++ = args[i].c;
+				break;
+			case STRBUF_CATX_INT:
+				magnitude = args[i].i < 0 ? -(unsigned long long)args[i].i : (unsigned long long)args[i].i;
+				if(args[i].i < 0)
+					*dst++ = '-';
+				size = decimal_digits(magnitude);
+				write_decimal(dst, size, magnitude);
+				dst += size;
+				break;
+			case STRBUF_CATX_UINT:
+				size = decimal_digits(args[i].u);
+				write_decimal(dst, size, args[i].u);
+				dst += size;
+				break;
+			case STRBUF_CATX_DOUBLE:
+				size = strlen(*doubles);
+				memcpy(dst, *doubles++, size);
+				dst += size;
+				break;
+		};
+		i++;
+	};
+}
+
+static int decimal_digits(unsigned long long value)
+{
+	int digits = 1;
+	while(value >= 10)
+	{
+		value /= 10;
+		digits++;
+	};
+	return digits;
+}
+
+//	Write exactly digits characters, from the least significant end
+static void write_decimal(char* dst, int digits, unsigned long long value)
+{
+	while(digits--)
+	{
+		dst[digits] = '0' + value % 10;
+		value /= 10;
+	};
+}
+
+//	Delete characters which are members of set, a bitmap with one bit for each value of unsigned char.
+//	Every character is copied, but the destination only advances past those which are kept, so the loop has no branches to mispredict.
+static void strip_set_from_buf(strbuf_t* buf, const uint8_t set[32])
+{
+	const unsigned char* src = (const unsigned char*)buf->cstr;
+	const unsigned char* end = &src[buf->size];
+	char* dst = buf->cstr;
+
+	while(src != end)
+	{
+		*dst = *src;
+		dst += !((set[*src >> 3] >> (*src & 7)) & 1);
+		src++;
+	};
+
+	buf->size = dst - buf->cstr;
+	buf->cstr[buf->size] = 0;
+}
+
+//	As strbuf_assign(), but converting the characters as they are copied. str may be the buffers own contents.
+static strview_t assign_converted(strbuf_t** buf_ptr, strview_t str, int conversion, const char table[256])
+{
+	strbuf_t* buf = NULL;
+	bool failed;
+	if(buf_ptr && *buf_ptr)
+	{
+		buf = *buf_ptr;
+		failed = !strview_is_valid(str) || (conversion == CONVERT_TABLE && !table);
+		if(!failed)
+		{
+			if(str.size > buf->capacity && buf_is_dynamic(buf))
+				change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, str.size));
+
+			failed = str.size > buf->capacity;
+		};
+		if(!failed)
+		{
+			convert_chars(buf->cstr, str.data, str.size, conversion, table);
+			buf->size = str.size;
+			buf->cstr[buf->size] = 0;
+		}
+		else
+			empty_buf(buf);
+		*buf_ptr = buf;
+	};
+
+	return strview_of_buf(buf);
+}
+
+//	Convert size characters from src to dst. dst may be equal to, or before src.
+//	Case is converted 8 characters at a time, each word is read before it is written, so overlapping is safe.
+static void convert_chars(char* dst, const char* src, int size, int conversion, const char table[256])
+{
+	uint64_t word;
+
+	if(conversion == CONVERT_TABLE)
+	{
+		while(size--)
+			*dst++ = table[(unsigned char)*src++];
+	}
+	else
+	{
+		while(size >= (int)sizeof(word))
+		{
+			memcpy(&word, src, sizeof(word));
+			word = conversion == CONVERT_UPPER ? convert_case_of_word(word, 'a', 'z') : convert_case_of_word(word, 'A', 'Z');
+			memcpy(dst, &word, sizeof(word));
+			src += sizeof(word);
+			dst += sizeof(word);
+			size -= sizeof(word);
+		};
+		if(size)
+		{
+			word = 0;
+			memcpy(&word, src, size);
+			word = conversion == CONVERT_UPPER ? convert_case_of_word(word, 'a', 'z') : convert_case_of_word(word, 'A', 'Z');
+			memcpy(dst, &word, size);
+		};
+	};
 }
 
-static bool view_contains_char(strview_t view, char c)
+//	Toggle the case of each byte of a word which is within first...last, which must be letters of the same case.
+//	The high bit of each byte is cleared first, so adding an offset to a byte can't carry into the next, and the high bit of the sum gives the comparison.
+//	Bytes which had their high bit set are not ASCII, and are left unchanged.
+static uint64_t convert_case_of_word(uint64_t word, char first, char last)
 {
-	bool retval = false;
+	uint64_t low_bits = word & (0x7F * BYTES_OF_ONE);
+	uint64_t above_last = low_bits + (0x7F - last) * BYTES_OF_ONE;
+	uint64_t from_first = low_bits + (0x80 - first) * BYTES_OF_ONE;
+	uint64_t in_range = ~word & (above_last ^ from_first) & (0x80 * BYTES_OF_ONE);
+	return word ^ (in_range >> 2);
+}
+
+//	Count the matches, and size the buffer for the result before modifying it.
+//	If find or replace are within the buffer they are copied first, as the rebuild will overwrite them.
+static strview_t replace_all(strbuf_t** buf_ptr, strview_t find, strview_t replace, bool nocase)
+{
+	strbuf_t* buf;
+	strbuf_t* copy = NULL;
+	strbuf_allocator_t allocator;
+	strview_t remaining;
+	long long new_size;
+	int count = 0;
+	bool failed;
 
-	if(strview_is_valid(view))
+	if(buf_ptr && *buf_ptr && strview_is_valid(find) && find.size && strview_is_valid(replace))
 	{
-		while(!retval && view.size)
+		buf = *buf_ptr;
+		remaining = strview_of_buf(buf);
+		remaining = find_next(remaining, find, nocase);
+		while(remaining.data)
 		{
-			retval |= (*view.data == c);
-			view.data++;
-			view.size--;
+			count++;
+			remaining.data += find.size;
+			remaining.size = &buf->cstr[buf->size] - remaining.data;
+			remaining = find_next(remaining, find, nocase);
+		};
+
+		new_size = buf->size + (long long)count * (replace.size - find.size);
+		failed = new_size > INT_MAX;
+
+		if(!failed && count && (buf_contains_str(buf, find) || buf_contains_str(buf, replace)))
+		{
+			allocator = buf_is_dynamic(buf) ? buf->allocator : strbuf_default_allocator;
+			failed = !allocator.allocator;
+			if(!failed)
+			{
+				copy = create_buf(find.size + replace.size, allocator);
+				memcpy(copy->cstr, find.data, find.size);
+				memcpy(&copy->cstr[find.size], replace.data, replace.size);
+				find.data = copy->cstr;
+				replace.data = &copy->cstr[find.size];
+			};
 		};
+
+		if(!failed && count)
+		{
+			if(buf_is_dynamic(buf) && buf->capacity < new_size)
+				change_buf_capacity(&buf, round_up_capacity(buf->allocator.growth, buf->size, new_size));
+			failed = buf->capacity < new_size;
+		};
+
+		if(failed)
+			empty_buf(buf);
+		else if(count)
+			replace_in_buf(buf, find, replace, new_size, nocase);
+
+		if(copy)
+			destroy_buf(&copy);
+		*buf_ptr = buf;
+	};
+
+	return buf_ptr ? strview_of_buf(*buf_ptr) : STRVIEW_INVALID;
+}
+
+//	Rebuild the contents in one forward pass. The buffer must have a capacity of at least new_size.
+//	When growing, the contents are first moved to the end of the new size, so that the output never overtakes the unread input.
+static void replace_in_buf(strbuf_t* buf, strview_t find, strview_t replace, int new_size, bool nocase)
+{
+	int shift = new_size > buf->size ? new_size - buf->size : 0;
+	char* dst = buf->cstr;
+	strview_t remaining = {.data = &buf->cstr[shift], .size = buf->size};
+	strview_t match;
+	int before;
+
+	memmove(&buf->cstr[shift], buf->cstr, buf->size);
+
+	match = find_next(remaining, find, nocase);
+	while(match.data)
+	{
+		before = match.data - remaining.data;
+		memmove(dst, remaining.data, before);
+		dst += before;
+		memcpy(dst, replace.data, replace.size);
+		dst += replace.size;
+		remaining.data += before + find.size;
+		remaining.size -= before + find.size;
+		match = find_next(remaining, find, nocase);
+	};
+	memmove(dst, remaining.data, remaining.size);
+
+	buf->size = new_size;
+	buf->cstr[buf->size] = 0;
+}
+
+//	Find the first occurrence of needle (which must not be empty), by scanning for it's first character.
+static strview_t find_next(strview_t haystack, strview_t needle, bool nocase)
+{
+	strview_t result = STRVIEW_INVALID;
+	const char* ptr = haystack.data;
+	const char* found;
+	int positions = haystack.size - needle.size + 1;	// the number of places the needle could start
+	char first = nocase ? tolower((unsigned char)needle.data[0]) : needle.data[0];
+	strview_t candidate = {.size = needle.size};
+
+	while(positions > 0 && !result.data)
+	{
+		if(nocase)
+		{
+			found = ptr;
+			while(found != &ptr[positions] && tolower((unsigned char)*found) != first)
+				found++;
+			if(found == &ptr[positions])
+				found = NULL;
+		}
+		else
+			found = memchr(ptr, first, positions);
+
+		if(found)
+		{
+			positions -= found + 1 - ptr;
+			ptr = found + 1;
+			candidate.data = found;
+			if(nocase ? strview_is_match_nocase_strview(candidate, needle) : !memcmp(found, needle.data, needle.size))
+				result = candidate;
+		}
+		else
+			positions = 0;
 	};
 
-	return retval;
+	return result;
 }
 
 #ifdef STRBUF_PROVIDE_PRNF
-static void char_handler_for_prnf(void* dst, char c)
+//	prnf passes literal text and strings as whole runs, and other output in runs of up to PRNF_SPAN_BUF_SIZE, so capacity is checked once per run.
+static void span_handler_for_prnf(void* dst, const char* data, int size)
 {
-	append_char_to_buf((strbuf_t**)dst, c);
+	strbuf_t** buf_ptr = dst;
+	char* space = strbuf_reserve(buf_ptr, size);
+
+	if(space)
+	{
+		memcpy(space, data, size);
+		strbuf_commit(buf_ptr, size);
+	}
+	else
+		empty_buf(*buf_ptr);
 }
 #endif
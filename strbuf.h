@@ -43,6 +43,10 @@
  * 
  * -DSTRBUF_PROVIDE_PRNF
  * Similar to printf, -but uses an alternative text formatter https://github.com/mickjc750/prnf
+ * This requires the version of prnf bundled in test/prnf.c, which adds vspanprnf(). Upstream prnf does not yet provide it.
+ * 
+ * -DSTRBUF_PROVIDE_STRNUM
+ * Allows strbuf_catx() to accept floating point values, which are formatted by strnum_format_double(). strnum.c must also be compiled, and linked with -lm.
  * 
  * -DSTRBUF_DEFAULT_ALLOCATOR_STDLIB
  * If you wish to use dynamic memory allocation, but can't be bothered providing an allocator.
@@ -50,8 +54,18 @@
  * -DSTRBUF_ASSERT_DEFAULT_ALLOCATOR_STDLIB
  * assert() that the malloc or realloc of the default allocator actually succeeded.
  * 
- * -DSTRBUF_CAPACITY_GROW_STEP=[size]
- * Defaults to 16. This is the minimum size by which the buffer will be expanded when needed.
+ * -DSTRBUF_CAPACITY_GROW_RATIO=[n]
+ * Defaults to 1. When a buffer needs to grow, it grows by at least 1/2^n of it's size. This is the default growth policy, see strbuf_set_growth().
+ * 
+ * -DSTRBUF_DEFAULT_ALLOCATOR_USABLE_SIZE
+ * Use malloc_usable_size() (glibc) so that the capacity of buffers from the default allocator includes any slack rounded up by malloc.
+ * 
+ * -DSTRBUF_PAGE_SIZE=[size]
+ * Defaults to 4096. The page size used by STRBUF_GROWTH_PAGED.
+ * 
+ * -DSTRBUF_CAPACITY_HOOK=[function]
+ * Call void function(strbuf_t* buf, int old_capacity) each time the capacity of a dynamic buffer is changed by growing or shrinking it.
+ * For example -DSTRBUF_CAPACITY_HOOK=strbuf_stats_capacity_hook attributes these events to the strbuf_stats_t in accessories/strbuf_stats.h
  * 
  */
 
@@ -115,6 +129,48 @@
    **********************************************************************************/ 
 	#define STRBUF_FIXED_CAP(cap)	((strbuf_t*)&((strbuf_space_t(cap)){.buf.capacity=(cap), .buf.size=0, .buf.allocator.allocator=NULL, .buf.allocator.app_data=NULL, .bdy[0]=0}))
 
+/**
+ * @def STRBUF_HYBRID_CAP(cap, fallback)
+ * @hideinitializer
+ * @brief (macro) Instantiate and provide the address of an initialized hybrid buffer, which starts with a fixed capacity and moves to the heap if it needs to grow.
+ * @param cap The capacity of the buffer before it moves.
+ * @param fallback A pointer to the strbuf_allocator_t to move to, or NULL to use the default allocator.
+ * @note See strbuf_create_hybrid().
+ * @note Example:
+ * @code{.c}
+ * strbuf_t* my_buf = STRBUF_HYBRID_CAP(64, NULL);
+ * strbuf_append(&my_buf, cstr("Hello"));	// no heap allocation yet
+ * strbuf_destroy(&my_buf);
+ * @endcode
+   **********************************************************************************/ 
+	#define STRBUF_HYBRID_CAP(cap, fallback)	strbuf_create_hybrid(STRBUF_FIXED_CAP(cap), (fallback))
+
+/**
+ * @def STRBUF_GROWTH_DEFAULT
+ * @brief Growth policy, buffers grow by at least 1/2^STRBUF_CAPACITY_GROW_RATIO of their size. See strbuf_set_growth().
+ **********************************************************************************/ 
+	#define STRBUF_GROWTH_DEFAULT		0
+
+/**
+ * @def STRBUF_GROWTH_RATIO(n)
+ * @hideinitializer
+ * @brief Growth policy, buffers grow by at least 1/2^n of their size. n may be 0 to 14, 0 doubles the size. Larger values are limited to 14.
+ **********************************************************************************/ 
+	#define STRBUF_GROWTH_RATIO(n)		(((n) < 14 ? ((n) > 0 ? (n) : 0) : 14) + 1)
+
+/**
+ * @def STRBUF_GROWTH_EXACT
+ * @brief Growth policy, buffers grow only to the capacity needed.
+ **********************************************************************************/ 
+	#define STRBUF_GROWTH_EXACT			0x100
+
+/**
+ * @def STRBUF_GROWTH_PAGED
+ * @brief Growth policy flag, allocations larger than STRBUF_PAGE_SIZE are rounded up to a whole number of pages.
+ * @note This may be combined with another policy, for example STRBUF_GROWTH_PAGED|STRBUF_GROWTH_RATIO(3) grows large buffers by 12.5% in whole pages.
+ **********************************************************************************/ 
+	#define STRBUF_GROWTH_PAGED			0x200
+
 /// @cond DEV
 //	This is used for counting the number of arguments to the strbuf_cat() macro below.
 // 	From https://stackoverflow.com/questions/4421681/how-to-count-the-number-of-arguments-passed-to-a-function-that-accepts-a-variabl
@@ -167,6 +223,90 @@
  **********************************************************************************/ 
  	#define strbuf_cat(buf_ptr, ...) _strbuf_cat(buf_ptr, PP_NARG(__VA_ARGS__), __VA_ARGS__)
 
+/**
+ * @def strbuf_catx(buf_ptr, ...)
+ * @brief (macro) Concatenate up to 32 views, C strings, characters and numbers into a buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param ... One or more arguments of type strview_t, char*, char, or any integer type. Floating point types are accepted if built with -DSTRBUF_PROVIDE_STRNUM, and not -DSTRNUM_NOFLOAT.
+ * @return A view of the resulting buffer contents.
+ * @note Integers are formatted in decimal. Floating point values are formatted by strnum_format_double(), using the fewest digits which convert back to the same value.
+ * @note The total size is calculated first, so the buffer is resized at most once, and numbers are formatted directly into the buffer.
+ * @note A character literal such as 'A' has type int in C, and will be formatted as a number. Use (char)'A' or "A" instead.
+ * @note If the destination buffer is dynamic, then ... arguments may be views within the destination.
+ * @note Appending by passing the buffers own contents as the first argument does not copy them.
+ * @note If a buffer of fixed capacity is unable to store the output, it will be emptied.
+ * @note Example:
+ * @code{.c}
+ * strbuf_t* my_buf = strbuf_create(0,NULL);
+ * strbuf_catx(&my_buf, "id=", id, " temp=", 21.5, (char)'\n');
+ * strbuf_catx(&my_buf, strbuf_view(&my_buf), "next line");	// append
+ * @endcode
+ **********************************************************************************/ 
+ 	#define strbuf_catx(buf_ptr, ...) _strbuf_catx(buf_ptr, PP_NARG(__VA_ARGS__), (strbuf_catx_arg_t[]){_STRBUF_CATX_MAP(PP_NARG(__VA_ARGS__), __VA_ARGS__)})
+
+/// @cond DEV
+//	Wrap each argument to strbuf_catx() in a strbuf_catx_arg_t according to it's type
+#if defined(STRBUF_PROVIDE_STRNUM) && !defined(STRNUM_NOFLOAT)
+	#define _STRBUF_CATX_FLOAT_TYPES		float: _strbuf_catx_double, double: _strbuf_catx_double, long double: _strbuf_catx_double,
+#else
+	#define _STRBUF_CATX_FLOAT_TYPES
+#endif
+
+	#define _STRBUF_CATX_ARG(x) _Generic((x),\
+		strview_t:			_strbuf_catx_view,\
+		char*:				_strbuf_catx_cstr,\
+		const char*:		_strbuf_catx_cstr,\
+		char:				_strbuf_catx_char,\
+		_Bool:				_strbuf_catx_uint,\
+		signed char:		_strbuf_catx_int,\
+		unsigned char:		_strbuf_catx_uint,\
+		short:				_strbuf_catx_int,\
+		unsigned short:		_strbuf_catx_uint,\
+		int:				_strbuf_catx_int,\
+		unsigned int:		_strbuf_catx_uint,\
+		long:				_strbuf_catx_int,\
+		unsigned long:		_strbuf_catx_uint,\
+		long long:			_strbuf_catx_int,\
+		_STRBUF_CATX_FLOAT_TYPES\
+		unsigned long long:	_strbuf_catx_uint\
+		)(x)
+
+	#define _STRBUF_CATX_MAP(n, ...)		_STRBUF_CATX_MAP_(n, __VA_ARGS__)
+	#define _STRBUF_CATX_MAP_(n, ...)		_STRBUF_CATX_MAP##n(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP1(a)		_STRBUF_CATX_ARG(a)
+	#define _STRBUF_CATX_MAP2(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP1(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP3(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP2(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP4(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP3(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP5(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP4(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP6(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP5(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP7(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP6(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP8(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP7(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP9(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP8(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP10(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP9(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP11(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP10(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP12(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP11(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP13(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP12(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP14(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP13(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP15(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP14(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP16(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP15(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP17(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP16(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP18(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP17(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP19(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP18(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP20(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP19(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP21(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP20(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP22(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP21(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP23(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP22(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP24(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP23(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP25(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP24(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP26(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP25(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP27(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP26(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP28(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP27(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP29(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP28(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP30(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP29(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP31(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP30(__VA_ARGS__)
+	#define _STRBUF_CATX_MAP32(a, ...)	_STRBUF_CATX_ARG(a), _STRBUF_CATX_MAP31(__VA_ARGS__)
+/// @endcond
+
 
 /**
  * @def strbuf_create(init, strbuf_allocator_t* allocator)
@@ -204,6 +344,7 @@
  * }
  * 	strbuf_allocator_t my_alloc = {.allocator = my_alloc_func};
  * @endcode
+ * @note The members usable_size and growth are optional, and may be left as 0.
  */
 	typedef struct strbuf_allocator_t
 	{
@@ -215,6 +356,13 @@
 		 * @param size Size of the new or re-sized allocation, or 0 if freeing memory.
 		 */
 		void* (*allocator)(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+		/**
+		 * @brief Optional function pointer, reporting the usable size of an allocation, which may be more than was requested.
+		 * @param this_allocator A pointer to the instance of this structure.
+		 * @param ptr A memory address returned by the allocator.
+		 */
+		size_t (*usable_size)(struct strbuf_allocator_t* this_allocator, void* ptr);
+		int growth;	///< The growth policy for buffers using this allocator, STRBUF_GROWTH_DEFAULT (0), STRBUF_GROWTH_RATIO(n) or STRBUF_GROWTH_EXACT, optionally with STRBUF_GROWTH_PAGED.
 	} strbuf_allocator_t;
 
 /**
@@ -231,6 +379,29 @@
 		char cstr[];					///< Beginning of the buffers contents.
 	} strbuf_t;
 
+/// @cond DEV
+//	An argument to strbuf_catx()
+	typedef struct strbuf_catx_arg_t
+	{
+		enum {STRBUF_CATX_VIEW, STRBUF_CATX_CHAR, STRBUF_CATX_INT, STRBUF_CATX_UINT, STRBUF_CATX_DOUBLE} type;
+		union
+		{
+			strview_t view;
+			char c;
+			long long i;
+			unsigned long long u;
+			double d;
+		};
+	} strbuf_catx_arg_t;
+
+	static inline strbuf_catx_arg_t _strbuf_catx_view(strview_t x)			{return (strbuf_catx_arg_t){.type = STRBUF_CATX_VIEW, .view = x};}
+	static inline strbuf_catx_arg_t _strbuf_catx_cstr(const char* x)		{return (strbuf_catx_arg_t){.type = STRBUF_CATX_VIEW, .view = cstr(x)};}
+	static inline strbuf_catx_arg_t _strbuf_catx_char(char x)				{return (strbuf_catx_arg_t){.type = STRBUF_CATX_CHAR, .c = x};}
+	static inline strbuf_catx_arg_t _strbuf_catx_int(long long x)			{return (strbuf_catx_arg_t){.type = STRBUF_CATX_INT, .i = x};}
+	static inline strbuf_catx_arg_t _strbuf_catx_uint(unsigned long long x)	{return (strbuf_catx_arg_t){.type = STRBUF_CATX_UINT, .u = x};}
+	static inline strbuf_catx_arg_t _strbuf_catx_double(double x)			{return (strbuf_catx_arg_t){.type = STRBUF_CATX_DOUBLE, .d = x};}
+/// @endcond
+
 
 /**
  * @def strbuf_append(strbuf_t** buf_ptr, str);
@@ -373,6 +544,31 @@
   **********************************************************************************/
 	strbuf_t* strbuf_create_fixed(void* addr, size_t addr_size);
 
+/**
+ * @brief Convert a buffer of fixed capacity into a hybrid buffer, retaining it's contents.
+ * @param fixed_buf The buffer, created by STRBUF_FIXED_CAP(), strbuf_create_fixed() or STRBUF_STATIC_INIT().
+ * @param fallback A pointer to the strbuf_allocator_t to use when the buffer needs to grow, or NULL to use the default allocator.
+ * @return A pointer to the hybrid buffer, which is fixed_buf.
+ * @note A hybrid buffer uses the memory provided until an operation needs more capacity, at which point it's contents are copied once to memory from the fallback allocator, and it continues as a normal dynamic buffer.
+ * @note Unlike a buffer of fixed capacity, a hybrid buffer is not emptied when it's capacity is exceeded.
+ * @note strbuf_destroy() only frees memory obtained from the fallback allocator, so should always be called.
+ * @note The fallback allocator is referenced, not copied, and must remain valid until the buffer has moved or been destroyed.
+ * @note If the fallback allocator is not available, the buffer remains of fixed capacity.
+ * @note Example:
+ * @code{.c}
+ * strbuf_t* my_buf = strbuf_create_hybrid(STRBUF_FIXED_CAP(64), NULL);
+ * @endcode
+  **********************************************************************************/
+	strbuf_t* strbuf_create_hybrid(strbuf_t* fixed_buf, strbuf_allocator_t* fallback);
+
+/**
+ * @brief Test if a buffer is a hybrid buffer which is still using the memory it was created with.
+ * @param buf The buffer, which may be NULL.
+ * @return True if the buffer was created by strbuf_create_hybrid() or STRBUF_HYBRID_CAP(), and has not yet moved to memory from the fallback allocator.
+ * @note Once a hybrid buffer has moved it is an ordinary dynamic buffer, and this returns false.
+  **********************************************************************************/
+	bool strbuf_is_hybrid(strbuf_t* buf);
+
 /**
  * @brief Concatenate one or more string views (strview_t) and assign the result to the buffer.
  * @param buf_ptr The address of a pointer to the buffer.
@@ -390,6 +586,16 @@
  **********************************************************************************/
 	strview_t strbuf_vcat(strbuf_t** buf_ptr, int n_args, va_list va);
 
+/**
+ * @brief Concatenate an array of views, characters and numbers, and assign the result to the buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param count The number of arguments in the array.
+ * @param args The arguments to concatenate.
+ * @return A view of the resulting buffer contents.
+ * @note This function should be used via the macro strbuf_catx(strbuf_t** buf_ptr, ...) which builds the argument array for you.
+ **********************************************************************************/
+	strview_t _strbuf_catx(strbuf_t** buf_ptr, int count, const strbuf_catx_arg_t args[count]);
+
 /**
  * @brief Append a single character to the buffer.
  * 
@@ -404,6 +610,33 @@
   **********************************************************************************/
 	strview_t strbuf_append_char(strbuf_t** buf_ptr, char c);
 
+/**
+ * @brief Reserve space at the end of the buffer, which may be written to directly.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param size The number of characters to reserve.
+ * @return A pointer to the space following the buffers contents, or NULL if the space could not be reserved.
+ * @note Nothing is appended until strbuf_commit() is called, the buffers contents and size are unchanged.
+ * @note The pointer is valid until the buffer is next modified.
+ * @note A failure to reserve does not empty a buffer of fixed capacity.
+ * @note Example:
+ * @code{.c}
+ * strbuf_t* my_buf = strbuf_create(0,NULL);
+ * char* space = strbuf_reserve(&my_buf, 10);
+ * if(space)
+ * 	strbuf_commit(&my_buf, serialize(space, 10));	// where serialize() returns the number of characters written
+ * @endcode
+  **********************************************************************************/
+	char* strbuf_reserve(strbuf_t** buf_ptr, int size);
+
+/**
+ * @brief Append characters which have been written directly into space provided by strbuf_reserve().
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param size The number of characters written, which should not exceed the size reserved.
+ * @return A view of the resulting buffer contents.
+ * @note The size is limited to the buffers remaining capacity.
+  **********************************************************************************/
+	strview_t strbuf_commit(strbuf_t** buf_ptr, int size);
+
 /**
  * @brief Get a view of the buffer contents.
  * @param buf_ptr The address of a pointer to the buffer.
@@ -428,6 +661,20 @@
  **********************************************************************************/
 	strview_t strbuf_grow(strbuf_t** buf_ptr, int min_size);
 
+/**
+ * @brief Set the growth policy of a buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param growth STRBUF_GROWTH_DEFAULT, STRBUF_GROWTH_RATIO(n) or STRBUF_GROWTH_EXACT, optionally combined with STRBUF_GROWTH_PAGED.
+ * @note Buffers initially take the growth policy of their allocator.
+ * @note This has no effect on a buffer with fixed capacity.
+ * @note Example:
+ * @code{.c}
+ * strbuf_t* my_buf = strbuf_create(0,NULL);
+ * strbuf_set_growth(&my_buf, STRBUF_GROWTH_PAGED | STRBUF_GROWTH_RATIO(3));
+ * @endcode
+ **********************************************************************************/
+	void strbuf_set_growth(strbuf_t** buf_ptr, int growth);
+
 /**
  * @brief Free memory allcoated to hold the buffer and it's contents.
  * @param buf_ptr The address of a pointer to the buffer. This pointer will be NULL after the operation.
@@ -442,6 +689,7 @@
  * @note Used for applications where an interface expects a regular heap allocated c string.
  * @note Care should be taken to free the returned string with the same allocator that was used to create the buffer.
  * @note If used on a static buffer, the ->cstr member is returned and *buf_ptr is NULLed.
+ * @note If used on a hybrid buffer which has not yet moved, it's contents are first copied to memory from the fallback allocator. If that fails, NULL is returned and *buf_ptr is left unchanged.
  * @note To instead copy the buffer contents to a pre-existing memory space, use strview_to_cstr().
  **********************************************************************************/
 	char* strbuf_to_cstr(strbuf_t** buf_ptr);
@@ -604,6 +852,89 @@
  **********************************************************************************/
 	strview_t strbuf_strip_cstr(strbuf_t** buf_ptr, const char* stripchars);
 
+/**
+ * @brief Delete all characters in the buffer for which a function returns non-zero.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param strip_char A function taking a character as an unsigned char value, such as isspace() or iscntrl() from ctype.h
+ * @return A view of the buffer contents.
+ * @note strip_char is called once for every value of unsigned char before the buffer is modified, not for each character in the buffer. It's result must depend only on the character.
+ **********************************************************************************/
+	strview_t strbuf_strip_if(strbuf_t** buf_ptr, int (*strip_char)(int c));
+
+/**
+ * @brief Convert the buffer contents to upper case.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @return A view of the buffer contents.
+ * @note Only the ASCII letters a-z are converted, the locale is not used.
+ **********************************************************************************/
+	strview_t strbuf_to_upper(strbuf_t** buf_ptr);
+
+/**
+ * @brief Convert the buffer contents to lower case.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @return A view of the buffer contents.
+ * @note Only the ASCII letters A-Z are converted, the locale is not used.
+ **********************************************************************************/
+	strview_t strbuf_to_lower(strbuf_t** buf_ptr);
+
+/**
+ * @brief Replace every character in the buffer using a table.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param table The replacement for each character, indexed by it's value as an unsigned char.
+ * @return A view of the buffer contents.
+ **********************************************************************************/
+	strview_t strbuf_translate(strbuf_t** buf_ptr, const char table[256]);
+
+/**
+ * @brief Assign a string converted to upper case to the buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param str The string to convert, which may be of data within the buffer.
+ * @return A view of the buffer contents.
+ * @note As for strbuf_assign(), followed by strbuf_to_upper(), but the string is converted as it is copied.
+ **********************************************************************************/
+	strview_t strbuf_assign_upper(strbuf_t** buf_ptr, strview_t str);
+
+/**
+ * @brief Assign a string converted to lower case to the buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param str The string to convert, which may be of data within the buffer.
+ * @return A view of the buffer contents.
+ * @note As for strbuf_assign(), followed by strbuf_to_lower(), but the string is converted as it is copied.
+ **********************************************************************************/
+	strview_t strbuf_assign_lower(strbuf_t** buf_ptr, strview_t str);
+
+/**
+ * @brief Assign a string to the buffer, replacing each character using a table.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param str The string to convert, which may be of data within the buffer.
+ * @param table The replacement for each character, indexed by it's value as an unsigned char.
+ * @return A view of the buffer contents.
+ * @note As for strbuf_assign(), followed by strbuf_translate(), but the string is converted as it is copied.
+ **********************************************************************************/
+	strview_t strbuf_assign_translated(strbuf_t** buf_ptr, strview_t str, const char table[256]);
+
+/**
+ * @brief Replace all occurrences of a string in the buffer.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param find The string to search for. Occurrences are found from the start of the buffer, and do not overlap.
+ * @param replace The string to replace each occurrence with.
+ * @return A view of the buffer contents.
+ * @note find and replace may reference data within the buffer.
+ * @note If the buffer size is fixed, and insufficient to hold the result the buffer will be emptied.
+ * @note If find is empty or invalid, or replace is invalid, the buffer is not modified.
+ **********************************************************************************/
+	strview_t strbuf_replace_all(strbuf_t** buf_ptr, strview_t find, strview_t replace);
+
+/**
+ * @brief Replace all occurrences of a string in the buffer, ignoring case when searching.
+ * @param buf_ptr The address of a pointer to the buffer.
+ * @param find The string to search for, ignoring case.
+ * @param replace The string to replace each occurrence with.
+ * @return A view of the buffer contents.
+ * @note As for strbuf_replace_all().
+ **********************************************************************************/
+	strview_t strbuf_replace_all_nocase(strbuf_t** buf_ptr, strview_t find, strview_t replace);
+
 /**
  * @brief Insert a zero terminator at the end of each view.
  * @param buf_ptr The address of a pointer to the buffer.
@@ -670,7 +1001,7 @@
  * @param ... The arguments for the placeholders.
  * @return A view of the buffer contents.
  * @note Only available if build with -DSTRBUF_PROVIDE_PRNF
- * @note This uses vfptrprnf() from prnf.h
+ * @note This uses vspanprnf() from prnf.h
  **********************************************************************************/
 	strview_t strbuf_prnf(strbuf_t** buf_ptr, const char* format, ...) __attribute__((format(printf, 2, 3)));
 
@@ -681,7 +1012,7 @@
  * @param va A variable argument list as a va_list type from stdarg.h
  * @return A view of the buffer contents.
  * @note Only available if build with -DSTRBUF_PROVIDE_PRNF
- * @note This uses vfptrprnf() from prnf.h
+ * @note This uses vspanprnf() from prnf.h
  **********************************************************************************/
 	strview_t strbuf_vprnf(strbuf_t** buf_ptr, const char* format, va_list va);
 
@@ -692,7 +1023,7 @@
  * @param ... The arguments for the placeholders.
  * @return A view of the buffer contents.
  * @note Only available if build with -DSTRBUF_PROVIDE_PRNF
- * @note This uses vfptrprnf() from prnf.h
+ * @note This uses vspanprnf() from prnf.h
  **********************************************************************************/
 	strview_t strbuf_append_prnf(strbuf_t** buf_ptr, const char* format, ...) __attribute__((format(printf, 2, 3)));
 
@@ -703,7 +1034,7 @@
  * @param va A variable argument list as a va_list type from stdarg.h
  * @return A view of the buffer contents.
  * @note Only available if build with -DSTRBUF_PROVIDE_PRNF
- * @note This uses vfptrprnf() from prnf.h
+ * @note This uses vspanprnf() from prnf.h
  **********************************************************************************/
 	strview_t strbuf_append_vprnf(strbuf_t** buf_ptr, const char* format, va_list va);
 #endif
@@ -1,14 +1,16 @@
 /**************************************************************************************************
  *  strnum.h
  *
- *  Fast, allocation-free numeric parsing from string views.
+ *  Fast, allocation-free numeric parsing from string views, and formatting of numbers.
  *
- *  Inspired by C++17 std::from_chars, with additional validation and range checking.
+ *  Inspired by C++17 std::from_chars and std::to_chars, with additional validation and range checking.
  *
  *  Features:
  *      - Works directly on strview_t (no null-termination required)
  *      - Supports integer and optional floating point parsing
  *      - Fine-grained parsing control via flags
+ *      - Integer formatting in decimal, hex or binary, with optional width and padding
+ *      - Shortest round trip formatting of float and double
  *
  *  Build Options:
  *      STRNUM_NOFLOAT   Disable floating point support (avoids -lm)
@@ -42,6 +44,17 @@
 //	#define STR_SI			(1<<6)	// (todo) Accept and evaluate trailing Si prefix
 //	#define STR_SIB			(1<<7)	// (todo) Accept and evaluate trailing binary Si prefix
 
+//	Options for the strnum_format_x functions only, STRNUM_BASE_BIN and STRNUM_BASE_HEX also apply.
+	#define STRNUM_ZEROPAD	(1<<8)	//	Pad to the width with leading zeros (after any sign or prefix) instead of spaces
+	#define STRNUM_UPPER	(1<<9)	//	Use upper case hex digits and prefixes
+	#define STRNUM_PREFIX	(1<<10)	//	Write a 0x or 0b prefix for hex or binary
+	#define STRNUM_SCI		(1<<11)	//	Always write floating point types with an exponent. STRNUM_NOEXP never writes an exponent.
+
+//	The size of a char[] which can hold any integer formatted with a width of 0, including the terminator.
+//	This is a sign, a 0b prefix, 64 binary digits, and the terminator.
+//	It is also sufficient for a float or double, unless STRNUM_NOEXP is given.
+	#define STRNUM_FORMAT_SIZE	68
+
 
 // 	Generic macro. Evaluates to the appropriate strnum_consume_x function for the destination type.
 // 	dst - A pointer to the destination.
@@ -78,6 +91,44 @@
 		)(dst, src, opt)
 	#endif
 
+// 	Generic macro. Evaluates to the appropriate strnum_format_x function for the value type.
+// 	dst - The destination char[], may be NULL if dst_size is 0.
+// 	dst_size - The size of the destination, including space for the terminator.
+// 	value - The number to format.
+// 	width - Minimum number of characters, negative to left justify.
+// 	opt - One or more STRNUM_x flags.
+	#ifndef STRNUM_NOFLOAT
+	#define strnum_format(dst, dst_size, value, width, opt) _Generic((value),\
+		unsigned char:			strnum_format_uchar,\
+		unsigned short:			strnum_format_ushort,\
+		unsigned int:			strnum_format_uint,\
+		unsigned long:			strnum_format_ulong,\
+		unsigned long long:		strnum_format_ullong,\
+		char:					strnum_format_char,\
+		signed char:			strnum_format_schar,\
+		short:					strnum_format_short,\
+		int:					strnum_format_int,\
+		long:					strnum_format_long,\
+		long long:				strnum_format_llong,\
+		float:					strnum_format_float,\
+		double:					strnum_format_double\
+		)(dst, dst_size, value, width, opt)
+	#else
+	#define strnum_format(dst, dst_size, value, width, opt) _Generic((value),\
+		unsigned char:			strnum_format_uchar,\
+		unsigned short:			strnum_format_ushort,\
+		unsigned int:			strnum_format_uint,\
+		unsigned long:			strnum_format_ulong,\
+		unsigned long long:		strnum_format_ullong,\
+		char:					strnum_format_char,\
+		signed char:			strnum_format_schar,\
+		short:					strnum_format_short,\
+		int:					strnum_format_int,\
+		long:					strnum_format_long,\
+		long long:				strnum_format_llong\
+		)(dst, dst_size, value, width, opt)
+	#endif
+
 //==================================================================================================
 // CONSUMER API (mutates source)
 //==================================================================================================
@@ -249,4 +300,70 @@
 #endif
 
 
+//==================================================================================================
+// FORMAT API (allocation-free)
+//==================================================================================================
+
+/**
+ * Format an integer as text.
+ *
+ * The number of characters needed is computed first, and the text is then written in a single
+ * pass from the least significant digit, two decimal digits (or one byte of hex) per step.
+ * The text is only written if it fits entirely, a partial number is never written.
+ * Signed values are written as a sign followed by the magnitude, in any base.
+ *
+ * Default behaviour:
+ *   - Decimal digits, or hex/binary with STRNUM_BASE_HEX/STRNUM_BASE_BIN
+ *   - No base prefix, unless STRNUM_PREFIX is given
+ *   - Lower case hex digits, unless STRNUM_UPPER is given
+ *   - Padded to width with leading spaces, or leading zeros with STRNUM_ZEROPAD
+ *   - A negative width pads with trailing spaces instead
+ *
+ * Parameters:
+ *   dst       Destination, may be NULL to only measure the text
+ *   dst_size  Size of the destination, including space for the terminator
+ *   value     The value to format
+ *   width     Minimum number of characters to write
+ *   options   STRNUM_x flags
+ *
+ * Returns:
+ *   The number of characters in the text, excluding the terminator.
+ *   If this is not less than dst_size nothing is written, except for a terminator at dst[0].
+ */
+	int strnum_format_uchar(char* dst, int dst_size, unsigned char value, int width, int options);
+	int strnum_format_ushort(char* dst, int dst_size, unsigned short value, int width, int options);
+	int strnum_format_uint(char* dst, int dst_size, unsigned int value, int width, int options);
+	int strnum_format_ulong(char* dst, int dst_size, unsigned long value, int width, int options);
+	int strnum_format_ullong(char* dst, int dst_size, unsigned long long value, int width, int options);
+	int strnum_format_char(char* dst, int dst_size, char value, int width, int options);
+	int strnum_format_schar(char* dst, int dst_size, signed char value, int width, int options);
+	int strnum_format_short(char* dst, int dst_size, short value, int width, int options);
+	int strnum_format_int(char* dst, int dst_size, int value, int width, int options);
+	int strnum_format_long(char* dst, int dst_size, long value, int width, int options);
+	int strnum_format_llong(char* dst, int dst_size, long long value, int width, int options);
+
+
+#ifndef STRNUM_NOFLOAT
+/**
+ * Format a floating point value as text, using the fewest digits which convert back to the same value.
+ *
+ * The digits are found with the Schubfach algorithm, without any big number arithmetic or format string.
+ * Converting the text back with strnum_value() (or any correctly rounding parser) gives the identical value.
+ * Where there is more than one shortest representation, the closest to the exact value is written.
+ *
+ * Default behaviour:
+ *   - Positional notation, unless the decimal exponent is above 20 or below -6, as javascript does
+ *   - Scientific notation (1.5e-7) always with STRNUM_SCI, or never with STRNUM_NOEXP
+ *   - Upper case E, INF and NAN with STRNUM_UPPER
+ *   - Width and STRNUM_ZEROPAD as for integers
+ *   - Negative zero is written as -0, infinity as inf or -inf, and NaN as nan
+ *
+ * Returns:
+ *   As for the integer types.
+ */
+	int strnum_format_float(char* dst, int dst_size, float value, int width, int options);
+	int strnum_format_double(char* dst, int dst_size, double value, int width, int options);
+#endif
+
+
 #endif
@@ -3,6 +3,9 @@
 
 	#include <limits.h>
 	#include <ctype.h>
+
+//	Compile the functions defined within strview.h here, unless they are static inline
+	#define STRVIEW_DEFINE_INLINE_API
 	#include "strview.h"
 
 //********************************************************************************************************
@@ -29,7 +32,6 @@
 
 	static strview_t split_first_delim(strview_t* strview_ptr, strview_t delims, const char* exclude_quotes);
 	static strview_t split_last_delim(strview_t* strview_ptr, strview_t delims, const char* exclude_quotes);
-	static strview_t split_index(strview_t* strview_ptr, int index);
 
 	static strview_t find_first(strview_t haystack, strview_t needle, int(*comp_func)(const void*,const void*, size_t));
 	static strview_t find_last(strview_t haystack, strview_t needle, int(*comp_func)(const void*,const void*, size_t));
@@ -43,11 +45,6 @@
 // Public functions
 //********************************************************************************************************
 
-strview_t cstr(const char* c_str)
-{
-	return c_str ? (strview_t){.data = c_str, .size = strlen(c_str)} : STRVIEW_INVALID;
-}
-
 char* strview_to_cstr(char* dst, size_t dst_size, strview_t str)
 {
 	size_t copy_size;
@@ -63,23 +60,6 @@ char* strview_to_cstr(char* dst, size_t dst_size, strview_t str)
 	return dst;
 }
 
-bool strview_is_valid(strview_t str)
-{
-	return !!str.data;
-}
-
-void strview_swap(strview_t* a, strview_t* b)
-{
-	strview_t tmp = *a;
-	*a = *b;
-	*b = tmp;
-}
-
-bool strview_is_match_strview(strview_t str1, strview_t str2)
-{
-	return (str1.size == str2.size) && (str1.data == str2.data || !memcmp(str1.data, str2.data, str1.size));
-}
-
 bool strview_is_match_cstr(strview_t str1, const char* str2)
 {
 	return strview_is_match_strview(str1, cstr(str2));
@@ -153,34 +133,6 @@ bool strview_contains_nocase(strview_t haystack, strview_t needle)
 	return strview_is_valid(strview_find_first_nocase(haystack, needle));
 }
 
-strview_t strview_sub(strview_t str, int begin, int end)
-{
-	strview_t result = (strview_t){.size = 0, .data = str.data};
-
-	if(str.data && str.size)
-	{
-		if(begin < 0)
-			begin = str.size + begin;
-		if(end < 0)
-			end = str.size + end;
-		
-		if(begin <= end && begin < str.size && end >= 0)
-		{
-			if(begin < 0)
-				begin = 0;
-			if(end > str.size)
-				end = str.size;
-
-			result.size = end-begin;
-			result.data = &str.data[begin];
-		}
-		else
-			result.data = NULL;
-	};
-
-	return result;
-}
-
 strview_t strview_trim_start_cstr(strview_t str, const char* chars_to_trim)
 {
 	return strview_trim_start_strview(str, cstr(chars_to_trim));
@@ -290,24 +242,6 @@ strview_t strview_split_last_delim(strview_t* strview_ptr, const char* delims, c
 	return result;
 }
 
-strview_t strview_split_index(strview_t* strview_ptr, int index)
-{
-	strview_t result = STRVIEW_INVALID;
-
-	if(strview_ptr)
-		result = split_index(strview_ptr, index);
-
-	return result;
-}
-
-char strview_pop_first_char(strview_t* strview_ptr)
-{
-	char result = 0;
-	if(strview_ptr && strview_ptr->size)
-		result = split_index(strview_ptr, 1).data[0];
-	return result;
-}
-
 strview_t strview_split_line(strview_t* strview_ptr, char* eol)
 {
 	strview_t result = STRVIEW_INVALID;
@@ -352,7 +286,7 @@ strview_t strview_split_left(strview_t* strview_ptr, strview_t pos)
 	if(strview_ptr && strview_is_valid(*strview_ptr) && strview_is_valid(pos))
 	{
 		if(strview_ptr->data <= pos.data && pos.data <= &strview_ptr->data[strview_ptr->size])
-			result = split_index(strview_ptr, (int)(pos.data - strview_ptr->data));
+			result = strview_split_index(strview_ptr, (int)(pos.data - strview_ptr->data));
 	};
 	return result;
 }
@@ -369,7 +303,7 @@ strview_t strview_split_right(strview_t* strview_ptr, strview_t pos)
 		split_point = &pos.data[pos.size];
 		if(src.data <= split_point && split_point <= &src.data[src.size])
 		{
-			result = split_index(&src, (int)(split_point - src.data));
+			result = strview_split_index(&src, (int)(split_point - src.data));
 			strview_swap(&result, &src);
 		};
 		*strview_ptr = src;
@@ -491,36 +425,6 @@ static strview_t split_last_delim(strview_t* strview_ptr, strview_t delims, cons
 	return result;
 }
 
-static strview_t split_index(strview_t* strview_ptr, int index)
-{
-	strview_t result = STRVIEW_INVALID;
-	strview_t remainder = *strview_ptr;
-	bool neg = index < 0;
-
-	if(neg)
-		index = strview_ptr->size + index;
-		
-	if(index < 0)
-		index = 0;
-	if(index > strview_ptr->size)
-		index = strview_ptr->size;
-
-	result.data = remainder.data;
-	result.size = index;
-	remainder.data += index;
-	remainder.size -= index;
-
-	if(!neg)
-		*strview_ptr = remainder;
-	else
-	{
-		*strview_ptr = result;
-		result = remainder;
-	};
-
-	return result;
-}
-
 strview_t strview_dequote(strview_t src)
 {
 	strview_t result = src;
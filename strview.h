@@ -9,6 +9,14 @@
  * 
  * strview.h may be used standalone, and does not depend on **strbuf.h**.
  * 
+ * 
+ * ## Build options
+ * -DSTRVIEW_INLINE
+ * Define the small and frequently called functions (cstr(), strview_is_valid(), strview_swap(), strview_is_match_strview(),
+ * strview_sub(), strview_split_index() and strview_pop_first_char()) as static inline functions within this header,
+ * instead of in strview.c. Useful where call overhead matters, and link time optimization is not available.
+ * This must be defined consistently for every file which includes strview.h, including strview.c.
+ * 
  */
 
 #ifndef _STRVIEW_H_
@@ -295,6 +303,16 @@
 		strview_t:		strview_find_last_nocase_strview\
 		)(haystack, needle)
 
+/// @cond DEV
+//	Applied to the functions which are defined within this header. When built with -DSTRVIEW_INLINE they are static inline in every file,
+//	otherwise strview.c defines STRVIEW_DEFINE_INLINE_API to compile the same definitions once, as external functions.
+	#ifdef STRVIEW_INLINE
+		#define STRVIEW_INLINE_API	static inline
+	#else
+		#define STRVIEW_INLINE_API
+	#endif
+/// @endcond
+
 //********************************************************************************************************
 // Public variables
 //********************************************************************************************************
@@ -314,7 +332,7 @@
  * strview_t some_view = cstr(some_string);
  * @endcode
   **********************************************************************************/
-	strview_t cstr(const char* c_str);
+	STRVIEW_INLINE_API strview_t cstr(const char* c_str);
 
 /**
  * @brief Write a view to a null terminated C string.
@@ -336,7 +354,7 @@
  * @param str The view to test.
  * @return true if the view is valid, or false if it is not.
   **********************************************************************************/
-	bool strview_is_valid(strview_t str);
+	STRVIEW_INLINE_API bool strview_is_valid(strview_t str);
 
 /**
  * @brief Test if needle is in haystack.
@@ -358,14 +376,14 @@
  * @brief Swap two views.
  * @note This does not move any data, only the two views are swapped.
   **********************************************************************************/
-	void strview_swap(strview_t* a, strview_t* b);
+	STRVIEW_INLINE_API void strview_swap(strview_t* a, strview_t* b);
 
 /**
  * @brief Test if the contents of two views match.
  * @return true if the contents match or if both views are invalid.
  * @note Use via macro strview_is_match()
   **********************************************************************************/
-	bool strview_is_match_strview(strview_t str1, strview_t str2);
+	STRVIEW_INLINE_API bool strview_is_match_strview(strview_t str1, strview_t str2);
 
 /**
  * @brief Test if the contents of a view matches the contents of a c string.
@@ -438,7 +456,7 @@
  * strview_t sub_view = strview_sub(source_view, 3, 7); // view THIS
  * @endcode
  * **********************************************************************************/
-	strview_t strview_sub(strview_t str, int begin, int end);
+	STRVIEW_INLINE_API strview_t strview_sub(strview_t str, int begin, int end);
 
 /**
  * @brief Trim both ends of a view.
@@ -620,7 +638,7 @@
  *  strview_t ftoj_view  = strview_split_index(&src_view, -5);	//view "FGHIJ"
  * @endcode
  * *********************************************************************************/
-	strview_t strview_split_index(strview_t* src, int index);
+	STRVIEW_INLINE_API strview_t strview_split_index(strview_t* src, int index);
 
 /**
  * @brief Split left of a view.
@@ -665,7 +683,7 @@
  * @param src The address of the view to pop a character from.
  * @return The first character from the source view, or 0 if the source is empty or invalid.
  * *********************************************************************************/
-	char strview_pop_first_char(strview_t* src);
+	STRVIEW_INLINE_API char strview_pop_first_char(strview_t* src);
  
 /**
  * @brief Split by line.
@@ -689,6 +707,101 @@
  * *********************************************************************************/
 	strview_t strview_dequote(strview_t src);
 
+//********************************************************************************************************
+// Inline functions
+//********************************************************************************************************
+
+#if defined(STRVIEW_INLINE) || defined(STRVIEW_DEFINE_INLINE_API)
+	STRVIEW_INLINE_API strview_t cstr(const char* c_str)
+	{
+		return c_str ? (strview_t){.data = c_str, .size = strlen(c_str)} : STRVIEW_INVALID;
+	}
+
+	STRVIEW_INLINE_API bool strview_is_valid(strview_t str)
+	{
+		return !!str.data;
+	}
 
+	STRVIEW_INLINE_API void strview_swap(strview_t* a, strview_t* b)
+	{
+		strview_t tmp = *a;
+		*a = *b;
+		*b = tmp;
+	}
+
+	STRVIEW_INLINE_API bool strview_is_match_strview(strview_t str1, strview_t str2)
+	{
+		return (str1.size == str2.size) && (str1.data == str2.data || !memcmp(str1.data, str2.data, str1.size));
+	}
+
+	STRVIEW_INLINE_API strview_t strview_sub(strview_t str, int begin, int end)
+	{
+		strview_t result = (strview_t){.size = 0, .data = str.data};
+
+		if(str.data && str.size)
+		{
+			if(begin < 0)
+				begin = str.size + begin;
+			if(end < 0)
+				end = str.size + end;
+			
+			if(begin <= end && begin < str.size && end >= 0)
+			{
+				if(begin < 0)
+					begin = 0;
+				if(end > str.size)
+					end = str.size;
+
+				result.size = end-begin;
+				result.data = &str.data[begin];
+			}
+			else
+				result.data = NULL;
+		};
+
+		return result;
+	}
+
+	STRVIEW_INLINE_API strview_t strview_split_index(strview_t* src, int index)
+	{
+		strview_t result = STRVIEW_INVALID;
+		strview_t remainder;
+		bool neg = index < 0;
+
+		if(src)
+		{
+			remainder = *src;
+			if(neg)
+				index = src->size + index;
+			if(index < 0)
+				index = 0;
+			if(index > src->size)
+				index = src->size;
+
+			result.data = remainder.data;
+			result.size = index;
+			remainder.data += index;
+			remainder.size -= index;
+
+			if(!neg)
+				*src = remainder;
+			else
+			{
+				*src = result;
+				result = remainder;
+			};
+		};
+
+		return result;
+	}
+
+	STRVIEW_INLINE_API char strview_pop_first_char(strview_t* src)
+	{
+		char result = 0;
+		if(src && src->size)
+			result = strview_split_index(src, 1).data[0];
+		return result;
+	}
 #endif
 
+#endif
@@ -389,6 +389,12 @@ Note that if you mistakenly mix up %s and %n, you will get a compilation warning
 //	void* out_vars is also passed to the void* parameter if the character handler.
 	int fptrprnf(void(*out_fptr)(void*, char), void* out_vars, const char* fmtstr, ...) __attribute__((format(printf, 3, 4)));
 
+//	Print. Sending runs of characters to the specified span handler, not including a terminating null.
+//	The span handler is passed a pointer to the characters and their count, which are only valid during the call.
+//	Literal text and %s strings are passed directly, shorter output is collected into runs of up to PRNF_SPAN_BUF_SIZE characters.
+//	void* out_vars is also passed to the void* parameter of the span handler.
+	int spanprnf(void(*out_fptr)(void*, const char*, int), void* out_vars, const char* fmtstr, ...) __attribute__((format(printf, 3, 4)));
+
 
 //	non-variadic versions of the above, accepting va_list
 //	The variadic functions above are quite small and call these. 
@@ -399,6 +405,7 @@ Note that if you mistakenly mix up %s and %n, you will get a compilation warning
 	int vsnprnf(char* dst, size_t dst_size, const char* fmtstr, va_list va);
     int vsnappf(char* dst, size_t dst_size, const char* fmtstr, va_list va);
 	int vfptrprnf(void(*out_fptr)(void*, char), void* out_vars, const char* fmtstr, va_list va);
+	int vspanprnf(void(*out_fptr)(void*, const char*, int), void* out_vars, const char* fmtstr, va_list va);
 
 #ifdef PLATFORM_AVR
 	int prnf_P(const char* fmtstr, ...);
@@ -411,6 +418,8 @@ Note that if you mistakenly mix up %s and %n, you will get a compilation warning
 	int vsnprnf_P(char* dst, size_t dst_size, const char* fmtstr, va_list va);
     int vsnappf_P(char* dst, size_t dst_size, const char* fmtstr, va_list va);
 	int vfptrprnf_P(void(*out_fptr)(void*, char), void* out_vars, const char* fmtstr, va_list va);
+	int spanprnf_P(void(*out_fptr)(void*, const char*, int), void* out_vars, const char* fmtstr, ...);
+	int vspanprnf_P(void(*out_fptr)(void*, const char*, int), void* out_vars, const char* fmtstr, va_list va);
 #endif
 
 #endif // _PRNF_H_
@@ -3,15 +3,18 @@
 
 	#include <stdlib.h>
 	#include <stdio.h>
+	#include <ctype.h>
 	#include <assert.h>
 	#include <limits.h>
 	#include <stdint.h>
 	#include <math.h>
+	#include <malloc.h>
 
 	#include "greatest.h"
 	#include "strbuf.h"
 	#include "strview.h"
 	#include "strnum.h"
+	#include "strbuf_arena.h"
 
 //********************************************************************************************************
 // Configurable defines
@@ -42,14 +45,19 @@
 //********************************************************************************************************
 
 	static void* allocator(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
+	static size_t usable_size(struct strbuf_allocator_t* this_allocator, void* ptr);
+	static void* failing_allocator(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size);
 
 	SUITE(suite_strbuf);
 	TEST test_strbuf_create_using_malloc(void);
 	TEST test_strbuf_create_using_allocator(void);
 	TEST test_strbuf_create_static(void);
+	TEST test_strbuf_create_hybrid(void);
 	TEST test_strbuf_create_init(void);
 	TEST test_strbuf_strcat(void);
+	TEST test_strbuf_catx(void);
 	TEST test_strbuf_shrink(void);
+	TEST test_strbuf_growth(void);
 	TEST test_strbuf_printf(void);
 	TEST test_strbuf_append_printf(void);
 	TEST test_strbuf_prnf(void);
@@ -62,6 +70,11 @@
 	TEST test_strbuf_insert_after(void);
 	TEST test_strbuf_to_cstr(void);
 	TEST test_strbuf_terminate_views(void);
+	TEST test_strbuf_reserve_commit(void);
+	TEST test_strbuf_replace_all(void);
+	TEST test_strbuf_strip(void);
+	TEST test_strbuf_case(void);
+	TEST test_strbuf_arena_release(void);
 
 	SUITE(suite_strview);
 	TEST test_strview_sub(void);
@@ -96,6 +109,8 @@
 	TEST test_strview_contains(void);
 	TEST test_strview_contains_nocase(void);
 	TEST test_strnum_value(void);
+	TEST test_strnum_format(void);
+	TEST test_strnum_format_double(void);
 
 //********************************************************************************************************
 // Public functions
@@ -123,14 +138,32 @@ static void* allocator(struct strbuf_allocator_t* this_allocator, void* ptr_to_f
 	return result;
 }
 
+//	Never provides memory, for testing allocation failures
+static void* failing_allocator(struct strbuf_allocator_t* this_allocator, void* ptr_to_free, size_t size)
+{
+	(void)this_allocator;
+	(void)size;
+	assert(!ptr_to_free);
+	return NULL;
+}
+
+static size_t usable_size(struct strbuf_allocator_t* this_allocator, void* ptr)
+{
+	(void)this_allocator;
+	return malloc_usable_size(ptr);
+}
+
 SUITE(suite_strbuf)
 {
 	RUN_TEST(test_strbuf_create_using_malloc);
 	RUN_TEST(test_strbuf_create_init);
 	RUN_TEST(test_strbuf_create_using_allocator);
 	RUN_TEST(test_strbuf_create_static);
+	RUN_TEST(test_strbuf_create_hybrid);
 	RUN_TEST(test_strbuf_strcat);
+	RUN_TEST(test_strbuf_catx);
 	RUN_TEST(test_strbuf_shrink);
+	RUN_TEST(test_strbuf_growth);
 	RUN_TEST(test_strbuf_printf);
 	RUN_TEST(test_strbuf_append_printf);
 	RUN_TEST(test_strbuf_prnf);
@@ -143,6 +176,11 @@ SUITE(suite_strbuf)
 	RUN_TEST(test_strbuf_insert_after);
 	RUN_TEST(test_strbuf_to_cstr);
 	RUN_TEST(test_strbuf_terminate_views);
+	RUN_TEST(test_strbuf_reserve_commit);
+	RUN_TEST(test_strbuf_replace_all);
+	RUN_TEST(test_strbuf_strip);
+	RUN_TEST(test_strbuf_case);
+	RUN_TEST(test_strbuf_arena_release);
 }
 
 SUITE(suite_strview)
@@ -176,6 +214,8 @@ SUITE(suite_strview)
 	RUN_TEST(test_strview_split_left);
 	RUN_TEST(test_strview_split_right);
 	RUN_TEST(test_strnum_value);
+	RUN_TEST(test_strnum_format);
+	RUN_TEST(test_strnum_format_double);
 	RUN_TEST(test_strview_dequote);
 	RUN_TEST(test_strview_contains);
 	RUN_TEST(test_strview_contains_nocase);
@@ -254,6 +294,81 @@ TEST test_strbuf_create_static(void)
 	PASS();
 }
 
+TEST test_strbuf_create_hybrid(void)
+{
+	strbuf_t* buf;
+	strbuf_t* fixed;
+	char* str;
+	strbuf_allocator_t fallback = {.allocator = allocator};
+
+	buf = STRBUF_HYBRID_CAP(16, &fallback);
+	fixed = buf;
+	ASSERT(buf);
+	ASSERT(buf->size == 0);
+	ASSERT(buf->capacity == 16);
+	ASSERT(strbuf_is_hybrid(buf));
+	ASSERT(!strbuf_is_hybrid(NULL));
+	ASSERT(!strbuf_is_hybrid(STRBUF_FIXED_CAP(16)));
+
+	// fits, so the buffer should not move
+	strbuf_assign(&buf, cstr("0123456789"));
+	ASSERT(buf == fixed);
+	ASSERT(!strcmp(buf->cstr, "0123456789"));
+
+	// shrinking should have no effect on the fixed storage
+	strbuf_shrink(&buf);
+	ASSERT(buf == fixed);
+	ASSERT(buf->capacity == 16);
+
+	// exceeds the capacity, so the buffer should move rather than empty, source data from itself as it moves
+	strbuf_append(&buf, strbuf_view(&buf));
+	ASSERT(buf != fixed);
+	ASSERT(buf->capacity >= 20);
+	ASSERT(buf->allocator.allocator == allocator);
+	ASSERT(!strbuf_is_hybrid(buf));
+	ASSERT(!strcmp(buf->cstr, "01234567890123456789"));
+
+	// having moved, it is an ordinary dynamic buffer
+	strbuf_append(&buf, cstr("ABCDEFGHIJ"));
+	ASSERT(!strcmp(buf->cstr, "01234567890123456789ABCDEFGHIJ"));
+	strbuf_destroy(&buf);
+	ASSERT(!buf);
+
+	// destroying a buffer which has not moved
+	buf = STRBUF_HYBRID_CAP(16, NULL);
+	strbuf_assign(&buf, cstr("Hello"));
+	strbuf_destroy(&buf);
+	ASSERT(!buf);
+
+	// strbuf_cat sourcing from the destination while moving
+	buf = STRBUF_HYBRID_CAP(8, NULL);
+	strbuf_assign(&buf, cstr("Hello"));
+	strbuf_cat(&buf, strbuf_view(&buf), cstr(" "), strbuf_view(&buf));
+	ASSERT(!strcmp(buf->cstr, "Hello Hello"));
+	strbuf_destroy(&buf);
+
+	// a buffer which has not moved should still provide a heap allocated c string
+	buf = STRBUF_HYBRID_CAP(16, NULL);
+	strbuf_assign(&buf, cstr("Hello"));
+	str = strbuf_to_cstr(&buf);
+	ASSERT(!buf);
+	ASSERT(!strcmp(str, "Hello"));
+	free(str);
+
+	// if the buffer can't move, no c string is provided and the buffer is left intact
+	fallback.allocator = failing_allocator;
+	buf = STRBUF_HYBRID_CAP(16, &fallback);
+	fixed = buf;
+	strbuf_assign(&buf, cstr("Hello"));
+	str = strbuf_to_cstr(&buf);
+	ASSERT(!str);
+	ASSERT(buf == fixed);
+	ASSERT(!strcmp(buf->cstr, "Hello"));
+	strbuf_destroy(&buf);
+
+	PASS();
+}
+
 TEST test_strbuf_strcat(void)
 {
 	#define INITIAL_BUF_CAPACITY 16
@@ -780,6 +895,281 @@ TEST test_strview_append_char(void)
 	PASS();
 }
 
+TEST test_strbuf_reserve_commit(void)
+{
+	strbuf_t* buf = strbuf_create(4, NULL);
+	strview_t view;
+	char* space;
+
+	strbuf_assign(&buf, cstr("abc"));
+	space = strbuf_reserve(&buf, 10);
+	ASSERT(space);
+	ASSERT(buf->capacity >= 13);
+	ASSERT(buf->size == 3);
+	ASSERT(!strcmp(buf->cstr, "abc"));	// nothing appended yet
+	ASSERT(space == &buf->cstr[3]);
+
+	memcpy(space, "defgh", 5);
+	view = strbuf_commit(&buf, 5);
+	ASSERT(buf->size == 8);
+	ASSERT(strview_is_match(view, cstr("abcdefgh")));
+	ASSERT(buf->cstr[8] == 0);
+
+	// commit is limited to the capacity
+	view = strbuf_commit(&buf, INT_MAX);
+	ASSERT(buf->size == buf->capacity);
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	ASSERT(!strbuf_reserve(&buf, -1));
+	ASSERT(!strbuf_reserve(&buf, INT_MAX));
+	strbuf_destroy(&buf);
+
+	// a fixed buffer is not emptied when reserve fails
+	buf = strbuf_create_fixed(static_buf, STATIC_BUFFER_SIZE);
+	strbuf_assign(&buf, cstr("abc"));
+	ASSERT(!strbuf_reserve(&buf, buf->capacity));
+	ASSERT(!strcmp(buf->cstr, "abc"));
+	space = strbuf_reserve(&buf, buf->capacity - 3);
+	ASSERT(space);
+	space[0] = 'd';
+	strbuf_commit(&buf, 1);
+	ASSERT(!strcmp(buf->cstr, "abcd"));
+
+	PASS();
+}
+
+TEST test_strbuf_replace_all(void)
+{
+	strbuf_t* buf = strbuf_create(0, NULL);
+	strview_t view;
+
+	// growing
+	strbuf_assign(&buf, cstr("a-b-c-"));
+	view = strbuf_replace_all(&buf, cstr("-"), cstr("+++"));
+	ASSERT(strview_is_match(view, cstr("a+++b+++c+++")));
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	// shrinking
+	view = strbuf_replace_all(&buf, cstr("+++"), cstr(""));
+	ASSERT(strview_is_match(view, cstr("abc")));
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	// same size, and no match
+	view = strbuf_replace_all(&buf, cstr("b"), cstr("B"));
+	ASSERT(strview_is_match(view, cstr("aBc")));
+	view = strbuf_replace_all(&buf, cstr("b"), cstr("x"));
+	ASSERT(strview_is_match(view, cstr("aBc")));
+
+	// matches do not overlap
+	strbuf_assign(&buf, cstr("aaaaa"));
+	view = strbuf_replace_all(&buf, cstr("aa"), cstr("b"));
+	ASSERT(strview_is_match(view, cstr("bba")));
+
+	// ignoring case
+	strbuf_assign(&buf, cstr("Hello hello HELLO"));
+	view = strbuf_replace_all_nocase(&buf, cstr("hello"), cstr("bye"));
+	ASSERT(strview_is_match(view, cstr("bye bye bye")));
+	view = strbuf_replace_all(&buf, cstr("BYE"), cstr("x"));
+	ASSERT(strview_is_match(view, cstr("bye bye bye")));
+
+	// find and replace from within the buffer
+	strbuf_assign(&buf, cstr("<x> and <x>"));
+	view = strbuf_replace_all(&buf, strview_sub(strbuf_view(&buf), 0, 3), strbuf_view(&buf));
+	ASSERT(strview_is_match(view, cstr("<x> and <x> and <x> and <x>")));
+	view = strbuf_replace_all(&buf, strview_sub(strbuf_view(&buf), 3, 8), strview_sub(strbuf_view(&buf), 4, 5));
+	ASSERT(strview_is_match(view, cstr("<x>a<x>a<x>a<x>")));
+
+	// empty or invalid find does nothing
+	view = strbuf_replace_all(&buf, cstr(""), cstr("z"));
+	ASSERT(strview_is_match(view, cstr("<x>a<x>a<x>a<x>")));
+	view = strbuf_replace_all(&buf, STRVIEW_INVALID, cstr("z"));
+	ASSERT(strview_is_match(view, cstr("<x>a<x>a<x>a<x>")));
+	strbuf_destroy(&buf);
+
+	// a fixed buffer is emptied if the result will not fit
+	buf = strbuf_create_fixed(static_buf, 10+sizeof(strbuf_t));
+	strbuf_assign(&buf, cstr("a.b.c"));
+	view = strbuf_replace_all(&buf, cstr("."), cstr(".."));
+	ASSERT(strview_is_match(view, cstr("a..b..c")));
+	view = strbuf_replace_all(&buf, cstr("."), cstr(".."));
+	ASSERT(view.size == 0);
+	ASSERT(buf->cstr[0] == 0);
+
+	PASS();
+}
+
+TEST test_strbuf_strip(void)
+{
+	strbuf_t* buf = strbuf_create(0, NULL);
+	strview_t view;
+
+	strbuf_assign(&buf, cstr(" a, b,,c ,"));
+	view = strbuf_strip(&buf, ", ");
+	ASSERT(strview_is_match(view, cstr("abc")));
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	// characters above 0x7F
+	strbuf_assign(&buf, cstr("\xFF" "a\x80" "b\xFF"));
+	view = strbuf_strip(&buf, cstr("\xFF"));
+	ASSERT(strview_is_match(view, cstr("a\x80" "b")));
+
+	// nothing to strip, and stripping everything
+	view = strbuf_strip(&buf, "xyz");
+	ASSERT(strview_is_match(view, cstr("a\x80" "b")));
+	view = strbuf_strip(&buf, "\x80" "ab");
+	ASSERT(view.size == 0);
+	ASSERT(buf->cstr[0] == 0);
+
+	strbuf_assign(&buf, cstr("\tline one\r\n line\x01 two\n"));
+	view = strbuf_strip_if(&buf, iscntrl);
+	ASSERT(strview_is_match(view, cstr("line one line two")));
+	view = strbuf_strip_if(&buf, isspace);
+	ASSERT(strview_is_match(view, cstr("lineonelinetwo")));
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	strbuf_destroy(&buf);
+	PASS();
+}
+
+TEST test_strbuf_case(void)
+{
+	strbuf_t* buf = strbuf_create(0, NULL);
+	strview_t view;
+	char table[256];
+	char expected[256];
+	int i;
+
+	// every character value, so both the word and tail conversions see every boundary
+	for(i = 0; i < 256; i++)
+		table[i] = (char)i;
+	strbuf_assign(&buf, (strview_t){.data = table, .size = 256});
+
+	view = strbuf_to_upper(&buf);
+	for(i = 0; i < 256; i++)
+		expected[i] = (i >= 'a' && i <= 'z') ? (char)(i - 0x20) : (char)i;
+	ASSERT(view.size == 256 && !memcmp(view.data, expected, 256));
+
+	view = strbuf_assign_lower(&buf, (strview_t){.data = &table[1], .size = 255});
+	for(i = 1; i < 256; i++)
+		expected[i] = (i >= 'A' && i <= 'Z') ? (char)(i + 0x20) : (char)i;
+	ASSERT(view.size == 255 && !memcmp(view.data, &expected[1], 255));
+	ASSERT(buf->cstr[buf->size] == 0);
+
+	strbuf_assign(&buf, cstr("Content-Type: text/HTML"));
+	ASSERT(strview_is_match(strbuf_to_lower(&buf), cstr("content-type: text/html")));
+	ASSERT(strview_is_match(strbuf_to_upper(&buf), cstr("CONTENT-TYPE: TEXT/HTML")));
+
+	// from within the buffer
+	view = strbuf_assign_lower(&buf, strview_sub(strbuf_view(&buf), 14, INT_MAX));
+	ASSERT(strview_is_match(view, cstr("text/html")));
+	view = strbuf_assign_upper(&buf, strview_sub(strbuf_view(&buf), 1, 4));
+	ASSERT(strview_is_match(view, cstr("EXT")));
+
+	// translate
+	for(i = 0; i < 256; i++)
+		table[i] = (char)i;
+	table['/'] = '_';
+	table['.'] = '_';
+	strbuf_assign(&buf, cstr("a/b.c"));
+	ASSERT(strview_is_match(strbuf_translate(&buf, table), cstr("a_b_c")));
+	view = strbuf_assign_translated(&buf, cstr("x.y/z"), table);
+	ASSERT(strview_is_match(view, cstr("x_y_z")));
+
+	strbuf_destroy(&buf);
+
+	// a fixed buffer is emptied if the string will not fit
+	buf = strbuf_create_fixed(static_buf, 8+sizeof(strbuf_t));
+	view = strbuf_assign_upper(&buf, cstr("short"));
+	ASSERT(strview_is_match(view, cstr("SHORT")));
+	view = strbuf_assign_upper(&buf, cstr("too long for it"));
+	ASSERT(view.size == 0);
+	ASSERT(buf->cstr[0] == 0);
+
+	PASS();
+}
+
+TEST test_strbuf_arena_release(void)
+{
+	strbuf_arena_t arena;
+	strbuf_arena_mark_t mark;
+	strbuf_t* grown;
+	strbuf_t* before;
+	strbuf_t* other;
+
+	strbuf_arena_init(&arena, 0, NULL);
+	grown = strbuf_create(8, &arena.allocator);
+	strbuf_assign(&grown, cstr("before"));
+	before = grown;
+
+	// grow in place past the mark, then release
+	mark = strbuf_arena_mark(&arena);
+	strbuf_append(&grown, cstr(", and grown after the mark"));
+	ASSERT(grown == before);
+	other = strbuf_create(8, &arena.allocator);
+	strbuf_assign(&other, cstr("released"));
+	strbuf_arena_release(&arena, mark);
+
+	// a new buffer must not overlap the grown one
+	other = strbuf_create(64, &arena.allocator);
+	strbuf_assign(&other, cstr("0123456789012345678901234567890123456789"));
+	ASSERT_STR_EQ("before, and grown after the mark", grown->cstr);
+	ASSERT((char*)other >= &grown->cstr[grown->capacity]);
+
+	// destroying the buffer before the mark must not give it's space to buffers after the mark
+	mark = strbuf_arena_mark(&arena);
+	strbuf_destroy(&other);
+	other = strbuf_create(64, &arena.allocator);
+	strbuf_assign(&other, cstr("after"));
+	strbuf_arena_release(&arena, mark);
+	ASSERT_STR_EQ("before, and grown after the mark", grown->cstr);
+
+	strbuf_arena_destroy(&arena);
+	PASS();
+}
+
+TEST test_strbuf_catx(void)
+{
+	strbuf_t* buf = strbuf_create(0, NULL);
+	const char* name = "temp";
+	unsigned char uc = 200;
+	strview_t view;
+
+	// mixed types
+	view = strbuf_catx(&buf, "id=", 42, " ", cstr(name), "=", -7, (char)',', uc, ',', (short)-32768);
+	ASSERT(strview_is_match(view, cstr("id=42 temp=-7,20044-32768")));	// ',' is an int
+	ASSERT(buf->size == (int)strlen(buf->cstr));
+
+	// integer limits
+	strbuf_catx(&buf, LLONG_MIN, " ", LLONG_MAX, " ", ULLONG_MAX, " ", 0);
+	ASSERT(!strcmp(buf->cstr, "-9223372036854775808 9223372036854775807 18446744073709551615 0"));
+
+	// floating point, shortest round trip
+	strbuf_catx(&buf, 21.5, " ", 0.1f, " ", 1e100, " ", -0.0, " ", 5e-324);
+	ASSERT(!strcmp(buf->cstr, "21.5 0.10000000149011612 1e100 -0 5e-324"));
+
+	// appending to itself, and sourcing from itself
+	strbuf_catx(&buf, "abc");
+	strbuf_catx(&buf, strbuf_view(&buf), 123);
+	ASSERT(!strcmp(buf->cstr, "abc123"));
+	strbuf_catx(&buf, 0, strbuf_view(&buf), strview_sub(strbuf_view(&buf), 3, 5));
+	ASSERT(!strcmp(buf->cstr, "0abc12312"));
+	strbuf_destroy(&buf);
+
+	// fixed capacity
+	buf = STRBUF_FIXED_CAP(8);
+	strbuf_catx(&buf, "x=", 12345);
+	ASSERT(!strcmp(buf->cstr, "x=12345"));
+	strbuf_catx(&buf, strbuf_view(&buf), 6);
+	ASSERT(!strcmp(buf->cstr, "x=123456"));
+	strbuf_catx(&buf, strbuf_view(&buf), 7);	// too big, empties the buffer
+	ASSERT(buf->size == 0);
+	strbuf_catx(&buf, "ab");
+	strbuf_catx(&buf, "x", strbuf_view(&buf));	// self reference not at the start fails on a fixed buffer
+	ASSERT(buf->size == 0);
+
+	PASS();
+}
+
 TEST test_strbuf_shrink(void)
 {
 	strbuf_t* buf = strbuf_create(200, NULL);
@@ -807,6 +1197,75 @@ TEST test_strbuf_shrink(void)
 	PASS();
 }
 
+TEST test_strbuf_growth(void)
+{
+	strbuf_allocator_t exact_allocator = {.allocator = allocator, .growth = STRBUF_GROWTH_EXACT};
+	strbuf_allocator_t usable_allocator = {.allocator = allocator, .usable_size = usable_size};
+	strbuf_t* buf;
+	int i;
+
+	// the default policy grows by 50%
+	buf = strbuf_create(10, NULL);
+	strbuf_assign(&buf, cstr("0123456789"));
+	strbuf_append(&buf, cstr("X"));
+	ASSERT(buf->capacity == 15);
+
+	// doubling
+	strbuf_set_growth(&buf, STRBUF_GROWTH_RATIO(0));
+	strbuf_assign(&buf, cstr("0123456789ABCDE"));
+	strbuf_append(&buf, cstr("X"));
+	ASSERT(buf->capacity == 30);
+	strbuf_destroy(&buf);
+
+	// exact, taken from the allocator
+	buf = strbuf_create(0, &exact_allocator);
+	strbuf_assign(&buf, cstr("0123456789"));
+	ASSERT(buf->capacity == 10);
+	strbuf_append(&buf, cstr("X"));
+	ASSERT(buf->capacity == 11);
+	ASSERT(!strcmp(buf->cstr, "0123456789X"));
+	strbuf_destroy(&buf);
+
+	// paged, small buffers are not affected, large allocations are whole pages
+	buf = strbuf_create(0, NULL);
+	strbuf_set_growth(&buf, STRBUF_GROWTH_PAGED | STRBUF_GROWTH_RATIO(3));
+	strbuf_assign(&buf, cstr("0123456789"));
+	ASSERT(buf->capacity == 10);
+	i = 0;
+	while(i++ < 1000)
+	{
+		strbuf_append(&buf, cstr("0123456789"));
+		if(buf->capacity > 4096)
+			ASSERT((sizeof(strbuf_t) + buf->capacity + 1) % 4096 == 0);
+	};
+	ASSERT(buf->size == 10010);
+	strbuf_destroy(&buf);
+
+	// the ratio is limited to the bits reserved for it
+	ASSERT(STRBUF_GROWTH_RATIO(15) == STRBUF_GROWTH_RATIO(14));
+	ASSERT(!(STRBUF_GROWTH_RATIO(100) & (STRBUF_GROWTH_EXACT | STRBUF_GROWTH_PAGED)));
+	ASSERT(STRBUF_GROWTH_RATIO(-1) == STRBUF_GROWTH_RATIO(0));
+
+	// a fixed buffer is unaffected, and it's policy is initialized whatever the memory held
+	memset(static_buf, 0xFF, STATIC_BUFFER_SIZE);
+	buf = strbuf_create_fixed(static_buf, STATIC_BUFFER_SIZE);
+	ASSERT(buf->allocator.growth == 0);
+	ASSERT(buf->allocator.usable_size == NULL);
+	strbuf_set_growth(&buf, STRBUF_GROWTH_EXACT);
+	ASSERT(buf->allocator.growth == 0);
+
+	// capacity should include any slack reported by the allocator
+	buf = strbuf_create(5, &usable_allocator);
+	ASSERT(buf->capacity >= 5);
+	ASSERT(buf->capacity == (int)(malloc_usable_size(buf) - sizeof(strbuf_t) - 1));
+	strbuf_assign(&buf, cstr("0123456789012345678901234567890123456789"));
+	ASSERT(buf->capacity == (int)(malloc_usable_size(buf) - sizeof(strbuf_t) - 1));
+	ASSERT(!strcmp(buf->cstr, "0123456789012345678901234567890123456789"));
+	strbuf_destroy(&buf);
+
+	PASS();
+}
+
 TEST test_strview_is_match(void)
 {
 	ASSERT(strview_is_match(cstr("Hello"), cstr("Hello")));
@@ -1108,8 +1567,27 @@ TEST test_strbuf_prnf(void)
 	ASSERT(!memcmp(str1.data, "Hello from prnf! have some numbers... 6246456 3466765 435234 4598756 94572 69 42597", str1.size));
 	ASSERT(buf->cstr[buf->size] == 0);	//check the 0 terminator is in place
 
+	//long strings and runs of short fields are output as spans
+	str1 = strbuf_prnf(&buf, "%s|%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c|%5s",
+		"0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF",
+		'a','b','c','d','e','f','g','h','i','j','a','b','c','d','e','f','g','h','i','j',
+		'a','b','c','d','e','f','g','h','i','j','a','b','c','d','e','f','g','h','i','j', "xy");
+	ASSERT(strview_is_match(str1, cstr("0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF|abcdefghijabcdefghijabcdefghijabcdefghij|   xy")));
+	ASSERT(buf->cstr[buf->size] == 0);
+
 	strbuf_destroy(&buf);
 	ASSERT(!buf);
+
+	//a fixed capacity buffer is emptied if the output does not fit
+	buf = strbuf_create_fixed(static_buf, STATIC_BUFFER_SIZE);
+	str1 = strbuf_prnf(&buf, "%s", "short");
+	ASSERT(strview_is_match(str1, cstr("short")));
+	str1 = strbuf_prnf(&buf, "%0*i", buf->capacity + 1, 7);
+	ASSERT(str1.size == 0);
+	ASSERT(buf->cstr[0] == 0);
+	str1 = strbuf_prnf(&buf, "%0*i", buf->capacity, 7);
+	ASSERT(str1.size == buf->capacity);
+	ASSERT(buf->cstr[buf->size-1] == '7');
 	PASS();
 }
 
@@ -2052,4 +2530,172 @@ TEST test_strnum_value(void)
 	strbuf_destroy(&buf);
 	ASSERT(!buf);
 	PASS();
-}
\ No newline at end of file
+}
+TEST test_strnum_format(void)
+{
+	char dst[STRNUM_FORMAT_SIZE];
+	char small[4];
+	int size;
+	long long illong;
+	strview_t v;
+
+	// Compare against printf at the limits of each type
+	#define TEST_FORMAT(fmt, val)								\
+	do															\
+	{															\
+		char expect[STRNUM_FORMAT_SIZE];						\
+		snprintf(expect, sizeof(expect), fmt, (val));			\
+		size = strnum_format(dst, sizeof(dst), (val), 0, 0);	\
+		ASSERT_EQ((int)strlen(expect), size);					\
+		ASSERT_STR_EQ(expect, dst);								\
+	}while(0)
+
+	TEST_FORMAT("%hhu", (unsigned char)0);
+	TEST_FORMAT("%hhu", (unsigned char)UCHAR_MAX);
+	TEST_FORMAT("%hu", (unsigned short)USHRT_MAX);
+	TEST_FORMAT("%u", UINT_MAX);
+	TEST_FORMAT("%lu", ULONG_MAX);
+	TEST_FORMAT("%llu", ULLONG_MAX);
+	TEST_FORMAT("%d", (char)CHAR_MIN);
+	TEST_FORMAT("%d", (char)CHAR_MAX);
+	TEST_FORMAT("%hhd", (signed char)SCHAR_MIN);
+	TEST_FORMAT("%hhd", (signed char)SCHAR_MAX);
+	TEST_FORMAT("%hd", (short)SHRT_MIN);
+	TEST_FORMAT("%d", INT_MIN);
+	TEST_FORMAT("%d", INT_MAX);
+	TEST_FORMAT("%ld", LONG_MIN);
+	TEST_FORMAT("%lld", LLONG_MIN);
+	TEST_FORMAT("%lld", LLONG_MAX);
+	TEST_FORMAT("%d", 9);
+	TEST_FORMAT("%d", 10);
+	TEST_FORMAT("%d", 99);
+	TEST_FORMAT("%d", 100);
+	TEST_FORMAT("%d", -1000);
+	#undef TEST_FORMAT
+
+	// Hex and binary
+	strnum_format(dst, sizeof(dst), 0xBEEFu, 0, STRNUM_BASE_HEX);
+	ASSERT_STR_EQ("beef", dst);
+	strnum_format(dst, sizeof(dst), 0xBEEFu, 0, STRNUM_BASE_HEX | STRNUM_UPPER | STRNUM_PREFIX);
+	ASSERT_STR_EQ("0XBEEF", dst);
+	strnum_format(dst, sizeof(dst), 0xABCu, 0, STRNUM_BASE_HEX);
+	ASSERT_STR_EQ("abc", dst);
+	strnum_format(dst, sizeof(dst), ULLONG_MAX, 0, STRNUM_BASE_HEX);
+	ASSERT_STR_EQ("ffffffffffffffff", dst);
+	strnum_format(dst, sizeof(dst), 0u, 0, STRNUM_BASE_BIN);
+	ASSERT_STR_EQ("0", dst);
+	strnum_format(dst, sizeof(dst), 0x15Bu, 0, STRNUM_BASE_BIN | STRNUM_PREFIX);
+	ASSERT_STR_EQ("0b101011011", dst);
+	strnum_format(dst, sizeof(dst), -5, 0, STRNUM_BASE_BIN);
+	ASSERT_STR_EQ("-101", dst);
+	size = strnum_format(dst, sizeof(dst), LLONG_MIN, 0, STRNUM_BASE_BIN | STRNUM_PREFIX);
+	ASSERT_EQ(STRNUM_FORMAT_SIZE-1, size);
+
+	// Width and padding
+	strnum_format(dst, sizeof(dst), -42, 6, 0);
+	ASSERT_STR_EQ("   -42", dst);
+	strnum_format(dst, sizeof(dst), -42, 6, STRNUM_ZEROPAD);
+	ASSERT_STR_EQ("-00042", dst);
+	strnum_format(dst, sizeof(dst), -42, -6, STRNUM_ZEROPAD);
+	ASSERT_STR_EQ("-42   ", dst);
+	strnum_format(dst, sizeof(dst), 0x2Au, 6, STRNUM_BASE_HEX | STRNUM_PREFIX | STRNUM_ZEROPAD);
+	ASSERT_STR_EQ("0x002a", dst);
+	strnum_format(dst, sizeof(dst), 12345, 2, 0);
+	ASSERT_STR_EQ("12345", dst);
+
+	// Measuring, and insufficient space writes nothing but the terminator
+	ASSERT_EQ(5, strnum_format(NULL, 0, 12345, 0, 0));
+	strcpy(small, "abc");
+	ASSERT_EQ(4, strnum_format(small, sizeof(small), 1234, 0, 0));
+	ASSERT_STR_EQ("", small);
+	ASSERT_EQ(3, strnum_format(small, sizeof(small), 123, 0, 0));
+	ASSERT_STR_EQ("123", small);
+
+	// Round trip through strnum_value
+	strnum_format(dst, sizeof(dst), LLONG_MIN, 0, STRNUM_BASE_HEX | STRNUM_PREFIX);
+	v = cstr(dst);
+	ASSERT_EQ(0, strnum_value(&illong, &v, 0));
+	ASSERT_EQ(LLONG_MIN, illong);
+
+	PASS();
+}
+
+TEST test_strnum_format_double(void)
+{
+	char dst[STRNUM_FORMAT_SIZE];
+	uint64_t bits = 88172645463325252ULL;
+	uint32_t fbits;
+	double value;
+	double parsed;
+	float fvalue;
+	float fparsed;
+	int i;
+
+	// Shortest representation, in each notation
+	#define TEST_FORMAT(val, opt, expect)							\
+	do																\
+	{																\
+		ASSERT_EQ((int)strlen(expect), strnum_format(dst, sizeof(dst), (val), 0, (opt)));	\
+		ASSERT_STR_EQ(expect, dst);									\
+	}while(0)
+
+	TEST_FORMAT(0.0, 0, "0");
+	TEST_FORMAT(-0.0, 0, "-0");
+	TEST_FORMAT(0.1, 0, "0.1");
+	TEST_FORMAT(0.1f, 0, "0.1");
+	TEST_FORMAT(123.456, 0, "123.456");
+	TEST_FORMAT(1e20, 0, "100000000000000000000");
+	TEST_FORMAT(1e21, 0, "1e21");
+	TEST_FORMAT(0.000001, 0, "0.000001");
+	TEST_FORMAT(1e-7, 0, "1e-7");
+	TEST_FORMAT(-2.5e-10, 0, "-2.5e-10");
+	TEST_FORMAT(-2.5e-10, STRNUM_NOEXP, "-0.00000000025");
+	TEST_FORMAT(123.456, STRNUM_SCI, "1.23456e2");
+	TEST_FORMAT(1.0, STRNUM_SCI | STRNUM_UPPER, "1E0");
+	TEST_FORMAT(5e-324, 0, "5e-324");
+	TEST_FORMAT(1.7976931348623157e308, 0, "1.7976931348623157e308");
+	TEST_FORMAT(9007199254740993.0, 0, "9007199254740992");
+	TEST_FORMAT(NAN, 0, "nan");
+	TEST_FORMAT(-INFINITY, STRNUM_UPPER, "-INF");
+	#undef TEST_FORMAT
+
+	// Width
+	strnum_format(dst, sizeof(dst), -1.5, 8, STRNUM_ZEROPAD);
+	ASSERT_STR_EQ("-00001.5", dst);
+	strnum_format(dst, sizeof(dst), -INFINITY, 6, STRNUM_ZEROPAD);
+	ASSERT_STR_EQ("  -inf", dst);
+	strnum_format(dst, sizeof(dst), 2.5, -5, 0);
+	ASSERT_STR_EQ("2.5  ", dst);
+
+	// Round trip through strnum_value, for pseudo random bit patterns
+	for(i = 0; i < 10000; i++)
+	{
+		bits ^= bits << 13;
+		bits ^= bits >> 7;
+		bits ^= bits << 17;
+		memcpy(&value, &bits, sizeof(value));
+		if(!isnan(value) && !isinf(value))
+		{
+			strnum_format(dst, sizeof(dst), value, 0, 0);
+			parsed = strnum_double(cstr(dst), 0, 0);
+			ASSERT_MEM_EQ(&value, &parsed, sizeof(value));
+		};
+
+		fbits = bits;
+		memcpy(&fvalue, &fbits, sizeof(fvalue));
+		if(!isnan(fvalue) && !isinf(fvalue))
+		{
+			strnum_format(dst, sizeof(dst), fvalue, 0, STRNUM_SCI);
+			fparsed = strnum_float(cstr(dst), 0, 0);
+			ASSERT_MEM_EQ(&fvalue, &fparsed, sizeof(fvalue));
+		};
+	};
+
+	// Correctly rounded parsing
+	ASSERT_EQ(0.1, strnum_double(cstr("0.1"), 0, 0));
+	ASSERT_EQ(2.2250738585072014e-308, strnum_double(cstr("2.2250738585072014e-308"), 0, 0));
+	ASSERT_EQ(9007199254740993.0, strnum_double(cstr("9007199254740993"), 0, 0));
+	ASSERT_EQ(16777216.0f, strnum_float(cstr("16777217"), 0, 0));
+
+	PASS();
+}